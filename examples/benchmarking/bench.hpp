@@ -0,0 +1,326 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// A tiny header-only micro-benchmark harness:
+// calibrate the clock (see minimal_timediff.cpp), warm up,
+// repeat the measurement (see measuring_time.cpp), and report
+// robust statistics instead of a single wall-clock guess.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+using Clock = std::chrono::high_resolution_clock;
+using Seconds = std::chrono::duration<double>;
+
+// keep the optimizer from deleting work whose result is never used
+
+template <typename T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile char const* sink;
+	sink = reinterpret_cast<char const volatile*>(&value);
+#endif
+}
+
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : : "memory");
+#endif
+}
+
+// smallest nonzero difference between two clock readings
+
+inline auto clock_resolution()
+{
+	static auto const resolution = []
+	{
+		auto min_diff = Seconds{1.0};
+
+		for (int i = 0; i < 100'000; ++i)
+		{
+			auto start = Clock::now();
+			auto end = Clock::now();
+
+			auto diff = Seconds{end - start};
+			if (Seconds{0} < diff && diff < min_diff) min_diff = diff;
+		}
+		return min_diff;
+	}();
+	return resolution;
+}
+
+struct Options
+{
+	int warmup = 2;             // untimed runs before measuring
+	int min_samples = 5;
+	int max_samples = 101;
+	double min_time = 0.5;      // seconds of measuring per case, if samples allow
+	double precision = 1000;    // a sample lasts at least precision * clock resolution
+};
+
+struct Result
+{
+	std::string name;
+	size_t size = 0;
+	size_t samples = 0;
+	size_t batch = 1;           // work items per sample (for very short work)
+	double min = 0;             // all times in seconds per work item
+	double median = 0;
+	double p99 = 0;
+	double mean = 0;
+	double ci_low = 0;          // 95% confidence interval of the median
+	double ci_high = 0;
+	std::vector<std::pair<std::string, double>> counters;   // per work item, e.g. comparisons
+};
+
+inline auto statistics(std::string name, size_t size, size_t batch, std::vector<double> times)
+{
+	std::sort(begin(times), end(times));
+
+	auto n = times.size();
+	auto rank = [&](double q) { return times[std::min(n - 1, size_t(q * (n - 1) + 0.5))]; };
+
+	// distribution-free interval: order statistics n/2 -/+ 1.96 sqrt(n)/2
+	auto half_width = 0.98 * std::sqrt(double(n));
+	auto lo = std::max(0.0, std::floor(n / 2.0 - half_width));
+	auto hi = std::min(double(n - 1), std::ceil(n / 2.0 + half_width));
+
+	auto result = Result{};
+	result.name = std::move(name);
+	result.size = size;
+	result.samples = n;
+	result.batch = batch;
+	result.min = times.front();
+	result.median = rank(0.5);
+	result.p99 = rank(0.99);
+	for (auto t : times) result.mean += t / n;
+	result.ci_low = times[size_t(lo)];
+	result.ci_high = times[size_t(hi)];
+	return result;
+}
+
+struct NoCheck
+{
+	template <typename State>
+	bool operator()(State const&) const { return true; }
+};
+
+// Measure work(state) on fresh states created by setup(size).
+// Only work is timed; setup is repeated for every work item,
+// so destructive operations (sorting, inserting) are measured fairly.
+// Afterwards check(state) must confirm each result.
+
+template <typename Setup, typename Work, typename Check = NoCheck>
+auto measure(std::string name, size_t size, Setup setup, Work work, Options const& options = {}, Check check = {})
+{
+	auto run_batch = [&](size_t batch)
+	{
+		std::vector<decltype(setup(size))> states;
+		states.reserve(batch);
+		for (size_t i = 0; i < batch; ++i) states.push_back(setup(size));
+
+		clobber_memory();
+		auto start = Clock::now();
+		for (auto& state : states)
+		{
+			work(state);
+			do_not_optimize(state);
+		}
+		auto end = Clock::now();
+		clobber_memory();
+
+		for (auto const& state : states)
+			if (!check(state)) throw std::runtime_error(name + ": wrong result");
+
+		return Seconds{end - start}.count();
+	};
+
+	for (int i = 0; i < options.warmup; ++i) run_batch(1);
+
+	// grow the batch until one sample is well above clock resolution
+	auto min_sample = options.precision * clock_resolution().count();
+	size_t batch = 1;
+	while (run_batch(batch) < min_sample && batch < 1'000'000) batch *= 2;
+
+	std::vector<double> times;
+	auto total = 0.0;
+
+	while (int(times.size()) < options.max_samples
+		&& (int(times.size()) < options.min_samples || total < options.min_time))
+	{
+		auto t = run_batch(batch);
+		total += t;
+		times.push_back(t / batch);
+	}
+	return statistics(std::move(name), size, batch, std::move(times));
+}
+
+// registry of benchmark cases, run for a sweep of problem sizes
+
+struct Case
+{
+	std::string name;
+	std::function<Result(size_t, Options const&)> run;
+};
+
+inline auto& registry()
+{
+	static std::vector<Case> cases;
+	return cases;
+}
+
+template <typename Setup, typename Work, typename Check = NoCheck>
+void add(std::string name, Setup setup, Work work, Check check = {})
+{
+	registry().push_back({name, [=](size_t size, Options const& options)
+	{
+		return measure(name, size, setup, work, options, check);
+	}});
+}
+
+// count(size) runs once per size, outside of timing, and returns the counters of one work item
+
+template <typename Setup, typename Work, typename Check, typename Count>
+void add(std::string name, Setup setup, Work work, Check check, Count count)
+{
+	registry().push_back({name, [=](size_t size, Options const& options)
+	{
+		auto result = measure(name, size, setup, work, options, check);
+		result.counters = count(size);
+		return result;
+	}});
+}
+
+// the largest size of a sweep unless the command line gives one
+constexpr size_t default_max_size = 100'000'000;
+
+// first, factor * first, ... below last: pass max_size + 1 to include max_size
+inline auto sizes(size_t first = 10, size_t last = default_max_size + 1, size_t factor = 10)
+{
+	std::vector<size_t> result;
+	for (auto size = first; size < last; size *= factor) result.push_back(size);
+	return result;
+}
+
+inline void print_header(std::ostream& os = std::cout)
+{
+	os << std::left << std::setw(40) << "case" << std::right
+	   << std::setw(12) << "size"
+	   << std::setw(8)  << "samples"
+	   << std::setw(14) << "min [s]"
+	   << std::setw(14) << "median [s]"
+	   << std::setw(14) << "p99 [s]"
+	   << "  95% CI of median\n";
+}
+
+inline void print(Result const& r, std::ostream& os = std::cout)
+{
+	os << std::left << std::setw(40) << r.name << std::right
+	   << std::setw(12) << r.size
+	   << std::setw(8)  << r.samples
+	   << std::scientific << std::setprecision(3)
+	   << std::setw(14) << r.min
+	   << std::setw(14) << r.median
+	   << std::setw(14) << r.p99
+	   << "  [" << r.ci_low << ", " << r.ci_high << "]"
+	   << std::defaultfloat;
+	for (auto const& [counter, value] : r.counters) os << "  " << counter << '=' << value;
+	os << '\n';
+}
+
+// usage: program [max_size]
+
+inline size_t max_size(int argc, char* argv[], size_t default_size = default_max_size)
+{
+	return argc > 1 ? std::strtoull(argv[1], nullptr, 10) : default_size;
+}
+
+// usage: program [max_size] [max_threads], for the benches that scale over threads
+
+inline unsigned max_threads(int argc, char* argv[], unsigned default_threads = std::thread::hardware_concurrency())
+{
+	return std::max(1u, argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : default_threads);
+}
+
+// 1, 2, 4, ... and max_threads itself
+inline std::vector<unsigned> thread_counts(unsigned max_threads)
+{
+	std::vector<unsigned> result;
+	for (unsigned threads = 1; threads < max_threads; threads *= 2) result.push_back(threads);
+	result.push_back(std::max(1u, max_threads));
+	return result;
+}
+
+// Stopwatch for one-off timings outside the registry: one run of work()
+template <typename Work>
+double seconds(Work&& work)
+{
+	auto start = Clock::now();
+	work();
+	clobber_memory();
+	return Seconds{Clock::now() - start}.count();
+}
+
+// the fastest of repeat runs of work(), each after an untimed setup()
+template <typename Setup, typename Work>
+double best_of(int repeat, Setup&& setup, Work&& work)
+{
+	auto best = HUGE_VAL;
+	for (int run = 0; run < repeat; ++run)
+	{
+		setup();
+		best = std::min(best, seconds(work));
+	}
+	return best;
+}
+
+template <typename Work>
+double best_of(int repeat, Work&& work)
+{
+	return best_of(repeat, [] {}, work);
+}
+
+// all registered cases for the sizes first_size, 10 * first_size, ... up to max_size
+inline int run(int argc, char* argv[], Options const& options = {},
+	size_t default_size = default_max_size, size_t first_size = 10)
+{
+	auto last = max_size(argc, argv, default_size);
+
+	std::cout << "clock resolution = " << clock_resolution().count() << " s\n";
+	print_header();
+
+	for (auto size : sizes(first_size, last + 1))
+	try
+	{
+		for (auto const& c : registry())
+			print(c.run(size, options));
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef BENCH_COUNTED_HPP
+#define BENCH_COUNTED_HPP
+
+// An element type that counts what an algorithm does with it:
+// comparisons (operator< and operator==) and element moves (copy or move,
+// construction or assignment). The counters are shared by all Counted<T>
+// and atomic, so parallel algorithms may use it too; time with plain T,
+// count with Counted<T>.
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+template <typename T>
+class Counted
+{
+public:
+	Counted() = default;
+	Counted(T value) : value_{value} {}
+
+	Counted(Counted const& other) : value_{other.value_} { moved(); }
+	Counted(Counted&& other) noexcept : value_{std::move(other.value_)} { moved(); }
+
+	Counted& operator=(Counted const& other)
+	{
+		value_ = other.value_;
+		moved();
+		return *this;
+	}
+
+	Counted& operator=(Counted&& other) noexcept
+	{
+		value_ = std::move(other.value_);
+		moved();
+		return *this;
+	}
+
+	T const& value() const { return value_; }
+
+	friend bool operator<(Counted const& a, Counted const& b)
+	{
+		compared();
+		return a.value_ < b.value_;
+	}
+
+	friend bool operator==(Counted const& a, Counted const& b)
+	{
+		compared();
+		return a.value_ == b.value_;
+	}
+
+	static void reset()
+	{
+		comparisons_ = 0;
+		moves_ = 0;
+	}
+
+	static auto comparisons() { return comparisons_.load(); }
+	static auto moves() { return moves_.load(); }
+
+	// counters of one call of f(), in the format of Result::counters
+	template <typename F>
+	static auto count(F&& f)
+	{
+		reset();
+		f();
+		return std::vector<std::pair<std::string, double>>{
+			{"comparisons", double(comparisons())},
+			{"moves", double(moves())}
+		};
+	}
+
+private:
+	static void compared() { comparisons_.fetch_add(1, std::memory_order_relaxed); }
+	static void moved() { moves_.fetch_add(1, std::memory_order_relaxed); }
+
+	T value_{};
+
+	inline static std::atomic<size_t> comparisons_{0};
+	inline static std::atomic<size_t> moves_{0};
+};
+
+} // namespace bench
+
+#endif
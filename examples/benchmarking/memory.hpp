@@ -0,0 +1,102 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+// Counting replacements of the global operator new/delete.
+// Include this header in exactly one translation unit of a program.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "rss.hpp"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace bench::memory
+{
+
+inline std::atomic<size_t> allocated_bytes{0};
+inline std::atomic<size_t> allocations{0};
+inline std::atomic<size_t> live_bytes{0};      // including allocator rounding, glibc only
+
+struct Snapshot
+{
+	size_t bytes;
+	size_t count;
+	size_t live;
+};
+
+inline auto snapshot()
+{
+	return Snapshot{
+		allocated_bytes.load(std::memory_order_relaxed),
+		allocations.load(std::memory_order_relaxed),
+		live_bytes.load(std::memory_order_relaxed)
+	};
+}
+
+inline size_t usable_size(void* p)
+{
+#if defined(__GLIBC__)
+	return malloc_usable_size(p);
+#else
+	return 0;
+#endif
+}
+
+inline void* counted_allocate(size_t size)
+{
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	auto p = std::malloc(size ? size : 1);
+	if (p) live_bytes.fetch_add(usable_size(p), std::memory_order_relaxed);
+	return p;
+}
+
+inline void counted_free(void* p)
+{
+	if (p) live_bytes.fetch_sub(usable_size(p), std::memory_order_relaxed);
+	std::free(p);
+}
+
+} // namespace bench::memory
+
+void* operator new(size_t size)
+{
+	if (auto p = bench::memory::counted_allocate(size)) return p;
+	throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size)
+{
+	if (auto p = bench::memory::counted_allocate(size)) return p;
+	throw std::bad_alloc{};
+}
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept
+{
+	return bench::memory::counted_allocate(size);
+}
+
+void* operator new[](size_t size, std::nothrow_t const&) noexcept
+{
+	return bench::memory::counted_allocate(size);
+}
+
+// not inlined: GCC would otherwise see std::free() paired with operator new
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void operator delete(void* p) noexcept { bench::memory::counted_free(p); }
+BENCH_NOINLINE void operator delete[](void* p) noexcept { bench::memory::counted_free(p); }
+BENCH_NOINLINE void operator delete(void* p, size_t) noexcept { bench::memory::counted_free(p); }
+BENCH_NOINLINE void operator delete[](void* p, size_t) noexcept { bench::memory::counted_free(p); }
+
+#endif
@@ -0,0 +1,367 @@
+#ifndef BENCH_RANDOM_DATA_HPP
+#define BENCH_RANDOM_DATA_HPP
+
+// Fast, reproducible input data for benchmarks.
+//
+// Xoshiro256 is xoshiro256++ (Blackman/Vigna), a UniformRandomBitGenerator
+// with jump() to skip 2^128 values. Lanes<N> runs N jumped generators side by side,
+// its loops have no dependencies across lanes so the compiler vectorizes them.
+//
+// fill() splits the output into fixed blocks, each with its own jumped stream,
+// and hands contiguous block ranges to threads: the data depends on the seed only,
+// never on the number of threads.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+
+class Xoshiro256
+{
+public:
+	using result_type = uint64_t;
+
+	explicit Xoshiro256(uint64_t seed = 0x853c49e6748fea9b)
+	{
+		// splitmix64 spreads the seed over all 256 state bits
+		for (auto& s : s_)
+		{
+			seed += 0x9e3779b97f4a7c15;
+			auto z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			s = z ^ (z >> 31);
+		}
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()()
+	{
+		auto result = rotl(s_[0] + s_[3], 23) + s_[0];
+		auto t = s_[1] << 17;
+		s_[2] ^= s_[0];
+		s_[3] ^= s_[1];
+		s_[1] ^= s_[2];
+		s_[0] ^= s_[3];
+		s_[2] ^= t;
+		s_[3] = rotl(s_[3], 45);
+		return result;
+	}
+
+	// equivalent to 2^128 calls of operator()
+	void jump()
+	{
+		constexpr uint64_t polynomial[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+		std::array<uint64_t, 4> s{};
+		for (auto word : polynomial)
+		{
+			for (int bit = 0; bit < 64; ++bit)
+			{
+				if (word & uint64_t{1} << bit)
+				{
+					for (int i = 0; i < 4; ++i) s[i] ^= s_[i];
+				}
+				(*this)();
+			}
+		}
+		s_ = s;
+	}
+
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+private:
+	template <size_t> friend class Lanes;
+	std::array<uint64_t, 4> s_;
+};
+
+// N streams of xoshiro256++, state stored lane by lane (structure of arrays)
+template <size_t N = 8>
+class Lanes
+{
+public:
+	static constexpr size_t size = N;
+
+	// takes the next N jumped streams of base, advancing base past them
+	explicit Lanes(Xoshiro256& base)
+	{
+		for (size_t lane = 0; lane < N; ++lane)
+		{
+			for (int i = 0; i < 4; ++i) s_[i][lane] = base.s_[i];
+			base.jump();
+		}
+	}
+
+	void operator()(uint64_t* out)
+	{
+		for (size_t lane = 0; lane < N; ++lane)
+		{
+			auto s0 = s_[0][lane], s1 = s_[1][lane], s2 = s_[2][lane], s3 = s_[3][lane];
+			out[lane] = Xoshiro256::rotl(s0 + s3, 23) + s0;
+			auto t = s1 << 17;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s_[0][lane] = s0;
+			s_[1][lane] = s1;
+			s_[2][lane] = s2;
+			s_[3][lane] = Xoshiro256::rotl(s3, 45);
+		}
+	}
+
+private:
+	alignas(64) uint64_t s_[4][N];
+};
+
+// a value in [0, range) for range <= 2^32: the upper 32 bits of x times range
+// (Lemire's multiply-shift, no division; vectorizes)
+inline uint64_t bounded_32(uint64_t x, uint64_t range)
+{
+	return ((x >> 32) * range) >> 32;
+}
+
+// a value in [0, range) for any range: the high 64 bits of x * range
+inline uint64_t bounded(uint64_t x, uint64_t range)
+{
+	if (range <= uint64_t(1) << 32) return bounded_32(x, range);
+
+	auto const low = [](uint64_t v) { return v & 0xFFFF'FFFF; };
+	auto ad = (x >> 32) * low(range), bc = low(x) * (range >> 32);
+	auto middle = (low(x) * low(range) >> 32) + low(ad) + low(bc);
+	return (x >> 32) * (range >> 32) + (ad >> 32) + (bc >> 32) + (middle >> 32);
+}
+
+inline double unit(uint64_t x)
+{
+	return double(x >> 11) * 0x1.0p-53;
+}
+
+// ranks 1..n with P(k) ~ 1/k^s, rejection-inversion sampling (Hörmann/Derflinger)
+class Zipf
+{
+public:
+	explicit Zipf(uint64_t n, double s = 1.0)
+	: n_{double(n)}
+	, s_{s}
+	{
+		h_x1_ = h_integral(1.5) - 1;
+		h_n_ = h_integral(n_ + 0.5);
+		cut_ = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+	}
+
+	template <typename Uniform>
+	uint64_t operator()(Uniform&& uniform) const
+	{
+		for (;;)
+		{
+			auto u = h_n_ + uniform() * (h_x1_ - h_n_);
+			auto x = h_integral_inverse(u);
+			auto k = std::clamp(std::floor(x + 0.5), 1.0, n_);
+			if (k - x <= cut_ || u >= h_integral(k + 0.5) - h(k)) return uint64_t(k);
+		}
+	}
+
+private:
+	// log1p(x)/x and expm1(x)/x, both stable around 0 (s close to 1)
+	static double log1p_x(double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x / 2; }
+	static double expm1_x(double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x / 2; }
+
+	double h(double x) const { return std::exp(-s_ * std::log(x)); }
+
+	double h_integral(double x) const
+	{
+		auto log_x = std::log(x);
+		return expm1_x((1 - s_) * log_x) * log_x;
+	}
+
+	double h_integral_inverse(double x) const
+	{
+		auto t = std::max(-1.0, x * (1 - s_));
+		return std::exp(log1p_x(t) * x);
+	}
+
+	double n_, s_;
+	double h_x1_, h_n_, cut_;
+};
+
+enum class Distribution { uniform, sorted, reverse, few_unique, zipf };
+
+inline char const* name(Distribution distribution)
+{
+	constexpr char const* names[] = {"uniform", "sorted", "reverse", "few-unique", "zipf"};
+	return names[int(distribution)];
+}
+
+constexpr uint64_t default_seed = 42;
+
+namespace random_detail
+{
+
+constexpr size_t block_size = 1 << 16;
+
+// block by block, with the generator of each block derived from seed and block number only
+template <typename Block>
+void parallel_blocks(size_t size, uint64_t seed, unsigned threads, Block block)
+{
+	using Generator = Lanes<>;
+	auto blocks = (size + block_size - 1) / block_size;
+	threads = unsigned(std::clamp<size_t>(threads, 1, std::max<size_t>(1, blocks / 4)));
+
+	auto run = [&](size_t first, size_t last)
+	{
+		auto base = Xoshiro256{seed};
+		for (size_t i = 0; i < first * Generator::size; ++i) base.jump();
+		for (auto b = first; b < last; ++b)
+		{
+			auto generator = Generator{base};
+			block(generator, b * block_size, std::min(size, (b + 1) * block_size));
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; ++t) workers.emplace_back(run, blocks * t / threads, blocks * (t + 1) / threads);
+	run(0, blocks / threads);
+	for (auto& worker : workers) worker.join();
+}
+
+// uniform values in [low, low + range)
+template <typename T>
+void fill_uniform(T* out, size_t size, uint64_t low, uint64_t range, uint64_t seed, unsigned threads)
+{
+	auto blocks = [=](auto pick)
+	{
+		parallel_blocks(size, seed, threads, [=](auto& generator, size_t first, size_t last)
+		{
+			constexpr auto lanes = std::decay_t<decltype(generator)>::size;
+			alignas(64) uint64_t random[lanes];
+			auto i = first;
+			for (; i + lanes <= last; i += lanes)
+			{
+				generator(random);
+				for (size_t lane = 0; lane < lanes; ++lane) out[i + lane] = T(low + pick(random[lane]));
+			}
+			generator(random);
+			for (size_t lane = 0; i < last; ++i, ++lane) out[i] = T(low + pick(random[lane]));
+		});
+	};
+	// the test on range stays out of the vectorized loop
+	if (range <= uint64_t(1) << 32) blocks([range](uint64_t x) { return bounded_32(x, range); });
+	else blocks([range](uint64_t x) { return bounded(x, range); });
+}
+
+template <typename T>
+void fill_zipf(T* out, size_t size, uint64_t n, uint64_t seed, unsigned threads)
+{
+	auto zipf = Zipf{n};
+	parallel_blocks(size, seed, threads, [=](auto& generator, size_t first, size_t last)
+	{
+		constexpr auto lanes = std::decay_t<decltype(generator)>::size;
+		alignas(64) uint64_t random[lanes];
+		size_t used = lanes;
+		auto uniform = [&]
+		{
+			if (used == lanes) generator(random), used = 0;
+			return unit(random[used++]);
+		};
+		for (auto i = first; i < last; ++i) out[i] = T(zipf(uniform));
+	});
+}
+
+// sorts values in [low, low + range) by counting when the range is small enough
+template <typename T>
+void sort_small_range(T* out, size_t size, uint64_t low, uint64_t range, bool descending)
+{
+	if (range > 2 * size + 1024)
+	{
+		std::sort(out, out + size);
+		if (descending) std::reverse(out, out + size);
+		return;
+	}
+	std::vector<uint32_t> counts(range);
+	for (size_t i = 0; i < size; ++i) ++counts[uint64_t(out[i]) - low];
+	auto expand = [&](uint64_t v) { out = std::fill_n(out, counts[v], T(low + v)); };
+	if (descending) for (auto v = range; v-- > 0;) expand(v);
+	else for (uint64_t v = 0; v < range; ++v) expand(v);
+}
+
+} // namespace random_detail
+
+inline unsigned default_threads()
+{
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// size values of an integral type, by default in [1, size] like the classic
+// std::uniform_int_distribution<int>(1, size) setup of the benches
+template <typename T>
+void fill(T* out, size_t size, Distribution distribution = Distribution::uniform,
+	uint64_t seed = default_seed, unsigned threads = default_threads())
+{
+	static_assert(std::is_integral_v<T>, "bench::fill generates integers");
+	using namespace random_detail;
+
+	auto range = uint64_t(std::clamp<size_t>(size, 1, std::numeric_limits<T>::max()));
+	switch (distribution)
+	{
+	case Distribution::uniform:
+		fill_uniform(out, size, 1, range, seed, threads);
+		break;
+	case Distribution::sorted:
+	case Distribution::reverse:
+		fill_uniform(out, size, 1, range, seed, threads);
+		sort_small_range(out, size, 1, range, distribution == Distribution::reverse);
+		break;
+	case Distribution::few_unique:
+		// 16 distinct values spread over the range
+		fill_uniform(out, size, 0, 16, seed, threads);
+		for (size_t i = 0; i < size; ++i) out[i] = T(1 + uint64_t(out[i]) * (range / 16));
+		break;
+	case Distribution::zipf:
+		fill_zipf(out, size, range, seed, threads);
+		break;
+	}
+}
+
+template <typename T = int>
+auto random_values(size_t size, Distribution distribution = Distribution::uniform, uint64_t seed = default_seed)
+{
+	auto data = std::vector<T>(size);
+	fill(data.data(), size, distribution, seed);
+	return data;
+}
+
+// make(key...), computed once and kept until the next call with another key: for inputs and
+// expected results that all cases of one size share. There is one slot per make type, so make
+// must be a lambda that depends on the key only. The reference stays valid until that next call.
+template <typename Make, typename... Key>
+auto const& cached(Make make, Key const&... key)
+{
+	static_assert(std::is_class_v<Make>, "bench::cached needs a lambda, functions of one type would share the slot");
+	using Value = std::invoke_result_t<Make&, Key const&...>;
+
+	static std::optional<std::pair<std::tuple<Key...>, Value>> slot;
+	if (!slot || slot->first != std::tie(key...))
+	{
+		slot.reset();   // the old value goes before the new one is made
+		slot.emplace(std::tuple<Key...>{key...}, make(key...));
+	}
+	return slot->second;
+}
+
+} // namespace bench
+
+#endif
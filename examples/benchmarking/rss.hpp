@@ -0,0 +1,53 @@
+#ifndef RSS_HPP
+#define RSS_HPP
+
+// Resident set size probes (Linux / POSIX).
+
+#include <cstddef>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace bench::memory
+{
+
+// resident set size in bytes right now, 0 if unknown
+
+inline size_t current_rss()
+{
+#if defined(__linux__)
+	size_t pages = 0, resident = 0;
+	if (auto file = std::fopen("/proc/self/statm", "r"))
+	{
+		if (std::fscanf(file, "%zu %zu", &pages, &resident) != 2) resident = 0;
+		std::fclose(file);
+	}
+	return resident * size_t(sysconf(_SC_PAGESIZE));
+#else
+	return 0;
+#endif
+}
+
+// highest resident set size of this process so far
+
+inline size_t peak_rss()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return size_t(usage.ru_maxrss);
+#else
+	return size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+	return 0;
+#endif
+}
+
+} // namespace bench::memory
+
+#endif
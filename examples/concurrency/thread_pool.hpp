@@ -0,0 +1,215 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+// A small work-stealing thread pool.
+// Each worker owns a task queue: it takes its own newest task first (LIFO, cache-warm)
+// and steals the oldest task of another worker when its queue runs dry.
+// Threads waiting for a TaskGroup help out instead of blocking.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()))
+	{
+		for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+		for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { work(i); });
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{sleep_mutex_};
+			stop_ = true;
+		}
+		wakeup_.notify_all();
+		for (auto& worker : workers_) worker.join();
+	}
+
+	ThreadPool(ThreadPool const&) = delete;
+	ThreadPool& operator=(ThreadPool const&) = delete;
+
+	auto size() const { return workers_.size(); }
+
+	void submit(Task task)
+	{
+		auto self = current_index();
+		auto index = self < queues_.size() ? self : next_++ % queues_.size();
+		{
+			// counted before it is visible, so a thief's --pending_ cannot come first
+			std::lock_guard<std::mutex> lock{sleep_mutex_};
+			++pending_;
+		}
+		{
+			std::lock_guard<std::mutex> lock{queues_[index]->mutex};
+			queues_[index]->tasks.push_back(std::move(task));
+		}
+		wakeup_.notify_one();
+	}
+
+	// run one queued task on the calling thread, if there is any
+	bool run_pending_task()
+	{
+		auto self = current_index();
+		auto task = Task{};
+		if (!take(self < queues_.size() ? self : 0, task)) return false;
+		task();
+		return true;
+	}
+
+	// index of the calling worker thread, or a value >= size()
+	size_t current_index() const
+	{
+		return owner() == this ? index() : size_t(-1);
+	}
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	static ThreadPool const*& owner() { thread_local ThreadPool const* pool = nullptr; return pool; }
+	static size_t& index() { thread_local size_t i = 0; return i; }
+
+	bool take(size_t self, Task& task)
+	{
+		auto n = queues_.size();
+		for (size_t k = 0; k < n; ++k)
+		{
+			auto& queue = *queues_[(self + k) % n];
+			std::lock_guard<std::mutex> lock{queue.mutex};
+			if (queue.tasks.empty()) continue;
+
+			if (k == 0)
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			std::lock_guard<std::mutex> sleep_lock{sleep_mutex_};
+			--pending_;
+			return true;
+		}
+		return false;
+	}
+
+	void work(size_t self)
+	{
+		owner() = this;
+		index() = self;
+
+		while (true)
+		{
+			auto task = Task{};
+			if (take(self, task))
+			{
+				task();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock{sleep_mutex_};
+			wakeup_.wait(lock, [this] { return stop_ || pending_ > 0; });
+			if (stop_ && pending_ == 0) return;
+		}
+	}
+
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<size_t> next_{0};
+
+	std::mutex sleep_mutex_;
+	std::condition_variable wakeup_;
+	size_t pending_ = 0;
+	bool stop_ = false;
+};
+
+// Tasks spawned together; wait() helps running them until all are done
+// and rethrows the first exception one of them threw.
+
+class TaskGroup
+{
+public:
+	explicit TaskGroup(ThreadPool& pool) : pool_{pool} {}
+	~TaskGroup() { join(); }
+
+	template <typename F>
+	void run(F f)
+	{
+		++remaining_;
+		pool_.submit([this, f = std::move(f)]() mutable
+		{
+			struct Done
+			{
+				std::atomic<size_t>& remaining;
+				~Done() { --remaining; }
+			} done{remaining_};
+
+			try
+			{
+				f();
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock{error_mutex_};
+				if (!error_) error_ = std::current_exception();
+			}
+		});
+	}
+
+	void wait()
+	{
+		join();
+		if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+	}
+
+private:
+	void join()
+	{
+		while (remaining_ > 0)
+		{
+			if (!pool_.run_pending_task()) std::this_thread::yield();
+		}
+	}
+
+	ThreadPool& pool_;
+	std::atomic<size_t> remaining_{0};
+	std::mutex error_mutex_;
+	std::exception_ptr error_;
+};
+
+// f(first, last) for chunks of [0, n) spread over the pool
+
+template <typename F>
+void parallel_for(ThreadPool& pool, size_t n, size_t chunks, F f)
+{
+	chunks = std::max<size_t>(1, std::min(chunks, n));
+	TaskGroup group{pool};
+	for (size_t c = 0; c < chunks; ++c)
+	{
+		auto first = n * c / chunks;
+		auto last = n * (c + 1) / chunks;
+		group.run([=, &f] { f(first, last); });
+	}
+	group.wait();
+}
+
+#endif
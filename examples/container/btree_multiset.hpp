@@ -0,0 +1,402 @@
+#ifndef BTREE_MULTISET_HPP
+#define BTREE_MULTISET_HPP
+
+// An ordered multiset as B+-tree:
+// values live sorted in linked leaves of many elements each,
+// all nodes are stored in two contiguous vectors and refer to each other by index.
+// Compared to std::multiset (one heap node per element)
+// there are far fewer allocations, less memory per element, and fewer cache misses.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+template <typename T, typename Compare = std::less<T>, size_t NodeBytes = 256>
+class btree_multiset
+{
+	using Index = std::uint32_t;
+	static constexpr Index none = Index(-1);
+
+	static constexpr size_t leaf_capacity =
+		std::max<size_t>(4, (NodeBytes - 2 * sizeof(Index)) / sizeof(T));
+	static constexpr size_t inner_capacity =          // children per inner node
+		std::max<size_t>(4, (NodeBytes - sizeof(Index)) / (sizeof(T) + sizeof(Index)));
+
+	struct Leaf
+	{
+		Index count = 0;
+		Index next = none;
+		T values[leaf_capacity];
+	};
+
+	struct Inner
+	{
+		Index count = 0;                    // number of children
+		T keys[inner_capacity - 1];         // keys[i] = smallest value below children[i+1]
+		Index children[inner_capacity];
+	};
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const*;
+		using reference = T const&;
+
+		iterator() = default;
+
+		reference operator*() const { return tree_->leaves_[leaf_].values[pos_]; }
+		pointer operator->() const { return &**this; }
+
+		iterator& operator++()
+		{
+			auto const& leaf = tree_->leaves_[leaf_];
+			if (++pos_ == leaf.count)
+			{
+				leaf_ = leaf.next;
+				pos_ = 0;
+			}
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		friend bool operator==(iterator a, iterator b) { return a.leaf_ == b.leaf_ && a.pos_ == b.pos_; }
+		friend bool operator!=(iterator a, iterator b) { return !(a == b); }
+
+	private:
+		friend class btree_multiset;
+
+		iterator(btree_multiset const* tree, Index leaf, Index pos)
+		: tree_{tree}, leaf_{leaf}, pos_{pos}
+		{
+			if (leaf_ != none && pos_ == tree_->leaves_[leaf_].count)
+			{
+				leaf_ = tree_->leaves_[leaf_].next;
+				pos_ = 0;
+			}
+		}
+
+		btree_multiset const* tree_ = nullptr;
+		Index leaf_ = none;
+		Index pos_ = 0;
+	};
+
+	using const_iterator = iterator;
+
+	btree_multiset() = default;
+
+	// bulk loading: sort, then build the tree bottom-up
+	template <typename It>
+	btree_multiset(It first, It last)
+	{
+		insert(first, last);
+	}
+
+	btree_multiset(std::initializer_list<T> values)
+	: btree_multiset(values.begin(), values.end())
+	{
+	}
+
+	auto size() const { return size_; }
+	auto empty() const { return size_ == 0; }
+
+	auto begin() const { return iterator{this, first_leaf(), 0}; }
+	auto end() const { return iterator{}; }
+
+	void clear()
+	{
+		leaves_.clear();
+		inners_.clear();
+		root_ = none;
+		height_ = 0;
+		size_ = 0;
+	}
+
+	iterator insert(T const& value)
+	{
+		if (root_ == none)
+		{
+			root_ = new_leaf();
+			height_ = 0;
+		}
+		path_.clear();
+		auto [leaf, pos] = find_leaf(value, [&](T const& a, T const& b) { return !comp_(b, a); }, &path_);
+		if (auto split = insert_into_leaf(leaf, pos, value))
+		{
+			auto [key, right] = *split;
+			insert_into_parents(key, right);
+			// value may have moved into the new leaf
+			std::tie(leaf, pos) = locate_inserted(leaf, pos, right);
+		}
+		++size_;
+		return iterator{this, leaf, pos};
+	}
+
+	// batched insert: sort the batch, then
+	// insert one by one (small batch, good locality) or merge and rebuild (large batch)
+	template <typename It>
+	void insert(It first, It last)
+	{
+		std::vector<T> batch(first, last);
+		std::sort(batch.begin(), batch.end(), comp_);
+
+		if (batch.size() * 8 < size_)
+		{
+			for (auto const& value : batch) insert(value);
+			return;
+		}
+
+		std::vector<T> all;
+		all.reserve(size_ + batch.size());
+		std::merge(begin(), end(), batch.begin(), batch.end(), std::back_inserter(all), comp_);
+		build(all);
+	}
+
+	auto lower_bound(T const& value) const
+	{
+		if (root_ == none) return end();
+		auto [leaf, pos] = find_leaf(value, [&](T const& a, T const& b) { return comp_(a, b); });
+		return iterator{this, leaf, pos};
+	}
+
+	auto upper_bound(T const& value) const
+	{
+		if (root_ == none) return end();
+		auto [leaf, pos] = find_leaf(value, [&](T const& a, T const& b) { return !comp_(b, a); });
+		return iterator{this, leaf, pos};
+	}
+
+	auto find(T const& value) const
+	{
+		auto pos = lower_bound(value);
+		return pos != end() && !comp_(value, *pos) ? pos : end();
+	}
+
+	auto count(T const& value) const
+	{
+		size_t n = 0;
+		for (auto pos = lower_bound(value); pos != end() && !comp_(value, *pos); ++pos) ++n;
+		return n;
+	}
+
+	auto contains(T const& value) const { return find(value) != end(); }
+
+	// bytes held by the node vectors
+	auto memory_footprint() const
+	{
+		return leaves_.capacity() * sizeof(Leaf) + inners_.capacity() * sizeof(Inner);
+	}
+
+private:
+	Index new_leaf()
+	{
+		leaves_.emplace_back();
+		return Index(leaves_.size() - 1);
+	}
+
+	Index new_inner()
+	{
+		inners_.emplace_back();
+		return Index(inners_.size() - 1);
+	}
+
+	Index first_leaf() const
+	{
+		if (root_ == none) return none;
+		auto node = root_;
+		for (auto level = height_; level > 0; --level) node = inners_[node].children[0];
+		return node;
+	}
+
+	// descend to the leaf position where before(element, value) stops holding,
+	// optionally remembering the (inner node, child) path
+	template <typename Before>
+	std::pair<Index, Index> find_leaf(T const& value, Before before,
+		std::vector<std::pair<Index, Index>>* path = nullptr) const
+	{
+		auto node = root_;
+		for (auto level = height_; level > 0; --level)
+		{
+			auto const& inner = inners_[node];
+			auto keys_end = inner.keys + inner.count - 1;
+			auto child = std::partition_point(inner.keys, keys_end,
+				[&](T const& key) { return before(key, value); }) - inner.keys;
+			if (path) path->emplace_back(node, Index(child));
+			node = inner.children[child];
+		}
+		auto const& leaf = leaves_[node];
+		auto pos = std::partition_point(leaf.values, leaf.values + leaf.count,
+			[&](T const& element) { return before(element, value); }) - leaf.values;
+		return {node, Index(pos)};
+	}
+
+	// returns separator key and new right sibling if the leaf had to split
+	std::optional<std::pair<T, Index>> insert_into_leaf(Index leaf, Index pos, T const& value)
+	{
+		if (leaves_[leaf].count < leaf_capacity)
+		{
+			auto& l = leaves_[leaf];
+			std::move_backward(l.values + pos, l.values + l.count, l.values + l.count + 1);
+			l.values[pos] = value;
+			++l.count;
+			return std::nullopt;
+		}
+
+		auto right = new_leaf();
+		auto& l = leaves_[leaf];
+		auto& r = leaves_[right];
+		auto half = Index(leaf_capacity / 2);
+
+		std::move(l.values + half, l.values + l.count, r.values);
+		r.count = l.count - half;
+		l.count = half;
+		r.next = l.next;
+		l.next = right;
+
+		auto& target = pos <= half ? l : r;
+		auto at = pos <= half ? pos : pos - half;
+		std::move_backward(target.values + at, target.values + target.count, target.values + target.count + 1);
+		target.values[at] = value;
+		++target.count;
+
+		return std::pair{r.values[0], right};
+	}
+
+	std::pair<Index, Index> locate_inserted(Index leaf, Index pos, Index right) const
+	{
+		auto half = Index(leaf_capacity / 2);
+		if (pos <= half) return {leaf, pos};
+		return {right, pos - half};
+	}
+
+	void insert_into_parents(T key, Index right)
+	{
+		while (!path_.empty())
+		{
+			auto [node, child] = path_.back();
+			path_.pop_back();
+
+			if (inners_[node].count < inner_capacity)
+			{
+				insert_child(inners_[node], child, key, right);
+				return;
+			}
+
+			// split the full inner node around its middle key
+			auto sibling = new_inner();
+			auto& in = inners_[node];
+			auto& sib = inners_[sibling];
+			auto half = Index(inner_capacity / 2);
+
+			auto middle = in.keys[half - 1];
+			std::move(in.keys + half, in.keys + in.count - 1, sib.keys);
+			std::move(in.children + half, in.children + in.count, sib.children);
+			sib.count = in.count - half;
+			in.count = half;
+
+			if (child < half) insert_child(in, child, key, right);
+			else insert_child(sib, child - half, key, right);
+
+			key = middle;
+			right = sibling;
+		}
+
+		// the root split: grow the tree by one level
+		auto root = new_inner();
+		auto& r = inners_[root];
+		r.count = 2;
+		r.keys[0] = key;
+		r.children[0] = root_;
+		r.children[1] = right;
+		root_ = root;
+		++height_;
+	}
+
+	static void insert_child(Inner& in, Index child, T const& key, Index right)
+	{
+		std::move_backward(in.keys + child, in.keys + in.count - 1, in.keys + in.count);
+		std::move_backward(in.children + child + 1, in.children + in.count, in.children + in.count + 1);
+		in.keys[child] = key;
+		in.children[child + 1] = right;
+		++in.count;
+	}
+
+	// build from sorted values: full leaves, then inner levels bottom-up
+	void build(std::vector<T> const& sorted)
+	{
+		clear();
+		if (sorted.empty()) return;
+
+		leaves_.reserve((sorted.size() + leaf_capacity - 1) / leaf_capacity);
+		std::vector<std::pair<Index, T>> level;  // node, smallest value below
+
+		for (size_t first = 0; first < sorted.size(); first += leaf_capacity)
+		{
+			auto last = std::min(sorted.size(), first + leaf_capacity);
+			auto leaf = new_leaf();
+			auto& l = leaves_[leaf];
+			std::copy(sorted.begin() + first, sorted.begin() + last, l.values);
+			l.count = Index(last - first);
+			if (leaf > 0) leaves_[leaf - 1].next = leaf;
+			level.emplace_back(leaf, l.values[0]);
+		}
+
+		while (level.size() > 1)
+		{
+			std::vector<std::pair<Index, T>> parents;
+			for (size_t first = 0; first < level.size(); first += inner_capacity)
+			{
+				auto last = std::min(level.size(), first + inner_capacity);
+				if (last - first == 1 && !parents.empty())
+				{
+					// avoid an inner node with a single child: move one over from the previous node
+					auto& prev = inners_[parents.back().first];
+					--prev.count;
+					--first;
+				}
+				auto node = new_inner();
+				auto& in = inners_[node];
+				in.count = Index(last - first);
+				for (size_t i = first; i < last; ++i)
+				{
+					in.children[i - first] = level[i].first;
+					if (i > first) in.keys[i - first - 1] = level[i].second;
+				}
+				parents.emplace_back(node, level[first].second);
+			}
+			level = std::move(parents);
+			++height_;
+		}
+		root_ = level.front().first;
+		size_ = sorted.size();
+	}
+
+	std::vector<Leaf> leaves_;
+	std::vector<Inner> inners_;
+	Index root_ = none;
+	Index height_ = 0;
+	size_t size_ = 0;
+	Compare comp_;
+	std::vector<std::pair<Index, Index>> path_;   // (inner node, child) visited by insert
+};
+
+#endif
@@ -0,0 +1,243 @@
+// Runs the container benchmarks with one size sweep
+// and writes machine-readable results:
+//
+//   container_bench [--max-size N] [--csv | --json] [--output file] [--verbose]
+//                   [--baseline file.csv] [--threshold 0.10] [--gate-min-size 10000]
+//
+// With --baseline, the median ns/element of each case is compared
+// against a CSV file written by an earlier run; the program exits
+// with status 2 if any case got slower by more than the threshold.
+// Only sizes from --gate-min-size on are gated: the small sizes take
+// microseconds and vary by more than the threshold between runs.
+// --verbose prints each case and size to stderr as it finishes.
+// An --output file that cannot be written is an error, status 1.
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/memory.hpp"
+#include "../benchmarking/random_data.hpp"
+
+template <typename Container>
+auto random_sequence(size_t size)
+{
+	auto values = bench::random_values(size);
+	if constexpr (std::is_same_v<Container, std::vector<int>>) return values;
+	else return Container(begin(values), end(values));
+}
+
+struct Record
+{
+	bench::Result result;
+	double ns_per_element;
+	size_t bytes_allocated;     // per work item
+	size_t rss;                 // resident set size after the work item
+};
+
+// run setup and work once more, untimed, to see what the work allocates
+
+template <typename Setup, typename Work>
+auto add_case(std::vector<std::pair<std::string, std::function<Record(size_t, bench::Options const&)>>>& cases,
+	std::string name, Setup setup, Work work)
+{
+	cases.emplace_back(name, [=](size_t size, bench::Options const& options)
+	{
+		auto result = bench::measure(name, size, setup, work, options);
+
+		auto state = setup(size);
+		auto before = bench::memory::snapshot();
+		work(state);
+		auto after = bench::memory::snapshot();
+		bench::do_not_optimize(state);
+
+		return Record{result, result.median * 1e9 / size,
+			after.bytes - before.bytes, bench::memory::current_rss()};
+	});
+}
+
+auto write_csv(std::ostream& os, std::vector<Record> const& records)
+{
+	os << "case,size,ns_per_element,median_s,min_s,p99_s,bytes_allocated,rss_bytes\n";
+	for (auto const& r : records)
+	{
+		os << r.result.name << ',' << r.result.size << ',' << r.ns_per_element << ','
+		   << r.result.median << ',' << r.result.min << ',' << r.result.p99 << ','
+		   << r.bytes_allocated << ',' << r.rss << '\n';
+	}
+}
+
+// a JSON string literal: quotes, backslashes and control characters escaped
+auto json_string(std::string const& s)
+{
+	std::string quoted = "\"";
+	for (auto c : s)
+	{
+		if (c == '"' || c == '\\') quoted += '\\';
+		if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[8];
+			std::snprintf(escaped, sizeof escaped, "\\u%04x", c);
+			quoted += escaped;
+		}
+		else quoted += c;
+	}
+	return quoted + '"';
+}
+
+auto write_json(std::ostream& os, std::vector<Record> const& records)
+{
+	os << "[\n";
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		auto const& r = records[i];
+		os << "  {\"case\": " << json_string(r.result.name) << ", \"size\": " << r.result.size
+		   << ", \"ns_per_element\": " << r.ns_per_element
+		   << ", \"median_s\": " << r.result.median
+		   << ", \"min_s\": " << r.result.min
+		   << ", \"p99_s\": " << r.result.p99
+		   << ", \"bytes_allocated\": " << r.bytes_allocated
+		   << ", \"rss_bytes\": " << r.rss << '}'
+		   << (i + 1 < records.size() ? ",\n" : "\n");
+	}
+	os << "]\n";
+}
+
+// baseline: (case, size) -> ns_per_element, read from an earlier CSV output
+
+auto read_baseline(std::string filename)
+{
+	std::map<std::pair<std::string, size_t>, double> baseline;
+	std::ifstream in(filename);
+	if (!in) throw std::runtime_error("cannot read baseline " + filename);
+
+	std::string line;
+	std::getline(in, line); // header
+	while (std::getline(in, line))
+	{
+		std::istringstream fields(line);
+		std::string name, size, ns;
+		std::getline(fields, name, ',');
+		std::getline(fields, size, ',');
+		std::getline(fields, ns, ',');
+		if (!ns.empty()) baseline[{name, std::stoull(size)}] = std::stod(ns);
+	}
+	return baseline;
+}
+
+int main(int argc, char* argv[])
+try
+{
+	size_t max_size = 10'000'000;
+	std::string format = "csv", output, baseline_file;
+	double threshold = 0.10;
+	size_t gate_min_size = 10'000;
+	auto verbose = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		auto value = [&] { return i + 1 < argc ? std::string(argv[++i]) : std::string(); };
+
+		if      (arg == "--max-size")  max_size = std::stoull(value());
+		else if (arg == "--csv")       format = "csv";
+		else if (arg == "--json")      format = "json";
+		else if (arg == "--output")    output = value();
+		else if (arg == "--verbose")   verbose = true;
+		else if (arg == "--baseline")  baseline_file = value();
+		else if (arg == "--threshold") threshold = std::stod(value());
+		else if (arg == "--gate-min-size") gate_min_size = std::stoull(value());
+		else
+		{
+			std::cerr << "unknown option " << arg << '\n';
+			return 1;
+		}
+	}
+
+	// before the benchmarks run, so that a wrong path fails at once
+	std::ofstream file;
+	if (!output.empty())
+	{
+		file.open(output);
+		if (!file) throw std::runtime_error("cannot write " + output);
+	}
+	auto& os = output.empty() ? std::cout : file;
+
+	std::vector<std::pair<std::string, std::function<Record(size_t, bench::Options const&)>>> cases;
+
+	add_case(cases, "vector_sort", random_sequence<std::vector<int>>,
+		[](auto& seq) { std::sort(begin(seq), end(seq)); });
+
+	add_case(cases, "list_sort", random_sequence<std::list<int>>,
+		[](auto& seq) { seq.sort(); });
+
+	add_case(cases, "multiset_insert",
+		[](size_t size) { return std::pair{random_sequence<std::vector<int>>(size), std::multiset<int>()}; },
+		[](auto& state)
+		{
+			auto& [values, seq] = state;
+			for (auto value : values) seq.insert(value);
+		});
+
+	add_case(cases, "unordered_multiset_insert",
+		[](size_t size) { return std::pair{random_sequence<std::vector<int>>(size), std::unordered_multiset<int>()}; },
+		[](auto& state)
+		{
+			auto& [values, seq] = state;
+			for (auto value : values) seq.insert(value);
+		});
+
+	auto options = bench::Options{};
+	options.min_time = 0.2;
+
+	std::vector<Record> records;
+	for (auto size : bench::sizes(10, max_size + 1))
+		for (auto const& [name, run] : cases)
+		{
+			records.push_back(run(size, options));
+			if (verbose) std::cerr << name << ' ' << size << '\n';
+		}
+
+	if (format == "json") write_json(os, records);
+	else                  write_csv(os, records);
+	if (!os.flush()) throw std::runtime_error("cannot write " + (output.empty() ? std::string("results") : output));
+
+	if (baseline_file.empty()) return 0;
+
+	auto baseline = read_baseline(baseline_file);
+	auto regressions = 0;
+
+	for (auto const& r : records)
+	{
+		auto pos = baseline.find({r.result.name, r.result.size});
+		if (r.result.size < gate_min_size || pos == baseline.end()) continue;
+
+		auto ratio = r.ns_per_element / pos->second;
+		if (ratio > 1 + threshold)
+		{
+			std::cerr << "REGRESSION " << r.result.name << " size " << r.result.size
+			          << ": " << pos->second << " -> " << r.ns_per_element
+			          << " ns/element (+" << (ratio - 1) * 100 << "%)\n";
+			++regressions;
+		}
+	}
+	return regressions ? 2 : 0;
+}
+catch (std::exception& e)
+{
+	std::cerr << e.what() << '\n';
+	return 1;
+}
@@ -0,0 +1,190 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+// External merge sort for binary files of trivially copyable elements
+// that do not fit into memory:
+// 1. read chunks that fit into the memory budget, sort them, write them as runs,
+// 2. stream all runs through a k-way merge into the output file.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "sorting.hpp"
+
+struct ExternalSortStats
+{
+	size_t elements = 0;
+	size_t runs = 0;
+	size_t bytes_read = 0;
+	size_t bytes_written = 0;
+	double seconds = 0;
+};
+
+namespace external_sort_detail
+{
+
+struct FileCloser
+{
+	void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+inline File open(std::filesystem::path const& path, char const* mode)
+{
+	auto file = File{std::fopen(path.c_str(), mode)};
+	if (!file) throw std::runtime_error("cannot open " + path.string());
+	return file;
+}
+
+// fread that throws on a read error, so that it does not pass for the end of the file
+template <typename T>
+size_t read_elements(File const& file, T* data, size_t count, std::filesystem::path const& path)
+{
+	auto n = std::fread(data, sizeof(T), count, file.get());
+	if (std::ferror(file.get())) throw std::runtime_error("cannot read " + path.string());
+	return n;
+}
+
+// removes the run files on every way out of external_sort, also when a read or write throws
+struct RemoveFiles
+{
+	explicit RemoveFiles(std::vector<std::filesystem::path> const& files) : paths{files} {}
+	RemoveFiles(RemoveFiles const&) = delete;
+	RemoveFiles& operator=(RemoveFiles const&) = delete;
+
+	~RemoveFiles()
+	{
+		std::error_code ignored;
+		for (auto const& path : paths) std::filesystem::remove(path, ignored);
+	}
+
+	std::vector<std::filesystem::path> const& paths;
+};
+
+// buffered sequential reader of one sorted run
+template <typename T>
+class RunReader
+{
+public:
+	RunReader(std::filesystem::path const& path, size_t buffer_elements, size_t& bytes_read)
+	: path_{path}
+	, file_{open(path, "rb")}
+	, buffer_(buffer_elements)
+	, bytes_read_{bytes_read}
+	{
+		refill();
+	}
+
+	bool done() const { return pos_ == end_; }
+	T const& front() const { return buffer_[pos_]; }
+
+	void pop()
+	{
+		if (++pos_ == end_) refill();
+	}
+
+private:
+	void refill()
+	{
+		end_ = read_elements(file_, buffer_.data(), buffer_.size(), path_);
+		bytes_read_ += end_ * sizeof(T);
+		pos_ = 0;
+	}
+
+	std::filesystem::path path_;
+	File file_;
+	std::vector<T> buffer_;
+	size_t pos_ = 0, end_ = 0;
+	size_t& bytes_read_;
+};
+
+} // namespace external_sort_detail
+
+template <typename T>
+auto external_sort(std::filesystem::path const& input, std::filesystem::path const& output,
+	size_t memory_bytes = 256 << 20,
+	std::filesystem::path const& tmpdir = std::filesystem::temp_directory_path())
+{
+	static_assert(std::is_trivially_copyable_v<T>, "external_sort moves raw bytes");
+	using namespace external_sort_detail;
+
+	auto start = std::chrono::steady_clock::now();
+	auto stats = ExternalSortStats{};
+	std::vector<std::filesystem::path> runs;
+	RemoveFiles remove_runs{runs};
+
+	// 1. sorted runs; radix_sort needs a second buffer, so use half the budget per chunk
+	{
+		auto in = open(input, "rb");
+		std::vector<T> chunk(std::max<size_t>(1, memory_bytes / 2 / sizeof(T)));
+
+		while (auto n = read_elements(in, chunk.data(), chunk.size(), input))
+		{
+			stats.bytes_read += n * sizeof(T);
+			stats.elements += n;
+			chunk.resize(n);
+
+			if constexpr (std::is_integral_v<T>) radix_sort(chunk);
+			else std::sort(begin(chunk), end(chunk));
+
+			runs.push_back(tmpdir / (output.filename().string() + ".run" + std::to_string(runs.size())));
+			auto out = open(runs.back(), "wb");
+			if (std::fwrite(chunk.data(), sizeof(T), n, out.get()) != n)
+				throw std::runtime_error("cannot write " + runs.back().string());
+			stats.bytes_written += n * sizeof(T);
+		}
+	}
+	stats.runs = runs.size();
+
+	// 2. k-way merge, the memory budget split into read buffers and one write buffer
+	{
+		auto buffer_elements = std::max<size_t>(1024, memory_bytes / (runs.size() + 1) / sizeof(T));
+		std::vector<RunReader<T>> readers;
+		readers.reserve(runs.size());
+		for (auto const& run : runs) readers.emplace_back(run, buffer_elements, stats.bytes_read);
+
+		auto out = open(output, "wb");
+		std::vector<T> buffer;
+		buffer.reserve(buffer_elements);
+		auto flush = [&]
+		{
+			if (std::fwrite(buffer.data(), sizeof(T), buffer.size(), out.get()) != buffer.size())
+				throw std::runtime_error("cannot write " + output.string());
+			stats.bytes_written += buffer.size() * sizeof(T);
+			buffer.clear();
+		};
+
+		std::vector<RunReader<T>*> heap;
+		for (auto& reader : readers) if (!reader.done()) heap.push_back(&reader);
+		auto greater = [](auto a, auto b) { return b->front() < a->front(); };
+		std::make_heap(begin(heap), end(heap), greater);
+
+		while (!heap.empty())
+		{
+			std::pop_heap(begin(heap), end(heap), greater);
+			auto reader = heap.back();
+			buffer.push_back(reader->front());
+			if (buffer.size() == buffer_elements) flush();
+
+			reader->pop();
+			if (reader->done()) heap.pop_back();
+			else std::push_heap(begin(heap), end(heap), greater);
+		}
+		flush();
+	}
+
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+#endif
@@ -0,0 +1,436 @@
+#ifndef FLAT_HASH_HPP
+#define FLAT_HASH_HPP
+
+// Open addressing hash containers in the style of "Swiss tables":
+// one control byte per slot (empty, or 7 bits of the hash),
+// probed a whole group of 16 (SSE2) or 32 (AVX2) slots at a time.
+// No node per element, no pointer per bucket.
+//
+// flat_hash_map<K, V>       unique keys
+// flat_hash_multiset<K>     duplicates are counted, not stored
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace flat_hash_detail
+{
+
+using Control = std::int8_t;
+constexpr Control empty = -128;        // full slots store 7 hash bits: 0 ... 127
+
+inline unsigned lowest_bit(std::uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return unsigned(__builtin_ctz(mask));
+#else
+	unsigned i = 0;
+	while (!(mask & 1)) { mask >>= 1; ++i; }
+	return i;
+#endif
+}
+
+// bit i of match() is set if control byte i of the group equals h
+
+#if defined(__AVX2__)
+constexpr size_t group_width = 32;
+
+struct Group
+{
+	__m256i ctrl;
+	explicit Group(Control const* p) : ctrl{_mm256_loadu_si256(reinterpret_cast<__m256i const*>(p))} {}
+	std::uint32_t match(Control h) const { return std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(h)))); }
+};
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr size_t group_width = 16;
+
+struct Group
+{
+	__m128i ctrl;
+	explicit Group(Control const* p) : ctrl{_mm_loadu_si128(reinterpret_cast<__m128i const*>(p))} {}
+	std::uint32_t match(Control h) const { return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h)))); }
+};
+#else
+constexpr size_t group_width = 16;
+
+struct Group
+{
+	Control const* ctrl;
+	explicit Group(Control const* p) : ctrl{p} {}
+	std::uint32_t match(Control h) const
+	{
+		std::uint32_t mask = 0;
+		for (size_t i = 0; i < group_width; ++i) mask |= std::uint32_t(ctrl[i] == h) << i;
+		return mask;
+	}
+};
+#endif
+
+// spread the bits of weak hashes (std::hash<int> is the identity)
+inline std::uint64_t mix(std::uint64_t h)
+{
+	h ^= h >> 32;
+	h *= 0x9E3779B97F4A7C15ull;
+	h ^= h >> 29;
+	return h;
+}
+
+} // namespace flat_hash_detail
+
+// transparent hash for heterogeneous lookup of string keys, e.g. by std::string_view
+struct string_hash
+{
+	using is_transparent = void;
+	size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class flat_hash_map
+{
+	using Control = flat_hash_detail::Control;
+	using Group = flat_hash_detail::Group;
+	static constexpr auto group_width = flat_hash_detail::group_width;
+	static constexpr auto empty_slot = flat_hash_detail::empty;
+
+	// heterogeneous lookup with Q != K only for transparent Hash and KeyEqual
+	template <typename Q, typename H = Hash, typename E = KeyEqual, typename = void>
+	struct lookup : std::is_same<Q, K> {};
+
+	template <typename Q, typename H, typename E>
+	struct lookup<Q, H, E, std::void_t<typename H::is_transparent, typename E::is_transparent>> : std::true_type {};
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<K const, V>;
+	using size_type = size_t;
+
+	template <bool Const>
+	class basic_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = flat_hash_map::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, value_type const&, value_type&>;
+		using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+
+		basic_iterator() = default;
+		basic_iterator(basic_iterator<false> const& other) : map_{other.map_}, index_{other.index_} {}
+
+		reference operator*() const { return map_->slots_[index_]; }
+		pointer operator->() const { return &map_->slots_[index_]; }
+
+		basic_iterator& operator++()
+		{
+			++index_;
+			skip_empty();
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		friend bool operator==(basic_iterator a, basic_iterator b) { return a.index_ == b.index_; }
+		friend bool operator!=(basic_iterator a, basic_iterator b) { return a.index_ != b.index_; }
+
+	private:
+		friend class flat_hash_map;
+		using Map = std::conditional_t<Const, flat_hash_map const, flat_hash_map>;
+
+		basic_iterator(Map* map, size_t index) : map_{map}, index_{index} { skip_empty(); }
+
+		void skip_empty()
+		{
+			while (index_ < map_->capacity_ && map_->ctrl_[index_] == empty_slot) ++index_;
+		}
+
+		Map* map_ = nullptr;
+		size_t index_ = 0;
+	};
+
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	flat_hash_map() = default;
+
+	explicit flat_hash_map(size_t capacity) { reserve(capacity); }
+
+	flat_hash_map(flat_hash_map const& other)
+	: hash_{other.hash_}
+	, equal_{other.equal_}
+	{
+		reserve(other.size());
+		for (auto const& value : other) emplace(value.first, value.second);
+	}
+
+	flat_hash_map(flat_hash_map&& other) noexcept { swap(other); }
+
+	flat_hash_map& operator=(flat_hash_map other) noexcept
+	{
+		swap(other);
+		return *this;
+	}
+
+	~flat_hash_map()
+	{
+		clear();
+		if (slots_) std::allocator<value_type>{}.deallocate(slots_, capacity_);
+	}
+
+	void swap(flat_hash_map& other) noexcept
+	{
+		using std::swap;
+		swap(ctrl_, other.ctrl_);
+		swap(slots_, other.slots_);
+		swap(capacity_, other.capacity_);
+		swap(size_, other.size_);
+		swap(hash_, other.hash_);
+		swap(equal_, other.equal_);
+	}
+
+	auto size() const { return size_; }
+	auto empty() const { return size_ == 0; }
+	auto capacity() const { return capacity_; }
+
+	auto begin() { return iterator{this, 0}; }
+	auto end() { return iterator{this, capacity_}; }
+	auto begin() const { return const_iterator{this, 0}; }
+	auto end() const { return const_iterator{this, capacity_}; }
+
+	void clear()
+	{
+		for (size_t i = 0; i < capacity_; ++i)
+		{
+			if (ctrl_[i] != empty_slot)
+			{
+				slots_[i].~value_type();
+				ctrl_[i] = empty_slot;
+			}
+		}
+		size_ = 0;
+	}
+
+	// make room for n elements without rehashing
+	void reserve(size_t n)
+	{
+		auto needed = group_width;
+		while (needed * 7 / 8 < n) needed *= 2;
+		if (needed > capacity_) rehash(needed);
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(K const& key, Args&&... args)
+	{
+		if ((size_ + 1) * 8 > capacity_ * 7) rehash(std::max(2 * capacity_, group_width));
+
+		auto [index, h2, found] = probe(key);
+		if (found) return {iterator{this, index}, false};
+
+		new (&slots_[index]) value_type(std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		ctrl_[index] = h2;
+		++size_;
+		return {iterator{this, index}, true};
+	}
+
+	auto insert(value_type const& value) { return emplace(value.first, value.second); }
+
+	// bulk insert: one reserve, then no rehashing on the way
+	template <typename It>
+	void insert(It first, It last)
+	{
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+			typename std::iterator_traits<It>::iterator_category>)
+		{
+			reserve(size_ + size_t(std::distance(first, last)));
+		}
+		for (; first != last; ++first) insert(*first);
+	}
+
+	V& operator[](K const& key) { return emplace(key).first->second; }
+
+	template <typename Q, typename = std::enable_if_t<lookup<Q>::value>>
+	iterator find(Q const& key)
+	{
+		return iterator{this, find_index(key)};
+	}
+
+	template <typename Q, typename = std::enable_if_t<lookup<Q>::value>>
+	const_iterator find(Q const& key) const
+	{
+		return const_iterator{this, find_index(key)};
+	}
+
+	template <typename Q, typename = std::enable_if_t<lookup<Q>::value>>
+	bool contains(Q const& key) const { return find_index(key) != capacity_; }
+
+	template <typename Q, typename = std::enable_if_t<lookup<Q>::value>>
+	size_t count(Q const& key) const { return contains(key) ? 1 : 0; }
+
+	// bytes held by control bytes and slots
+	auto memory_footprint() const { return capacity_ * (sizeof(Control) + sizeof(value_type)); }
+
+private:
+	// position in a group sequence: triangular numbers visit every group once
+	// if the number of groups is a power of two
+	struct Probe
+	{
+		size_t mask, group, step = 0;
+		size_t offset() const { return group * group_width; }
+		void next() { group = (group + ++step) & mask; }
+	};
+
+	template <typename Q>
+	auto hash(Q const& key) const
+	{
+		auto h = flat_hash_detail::mix(std::uint64_t(hash_(key)));
+		return std::pair{size_t(h), Control(h >> 57)};
+	}
+
+	template <typename Q>
+	size_t find_index(Q const& key) const
+	{
+		if (size_ == 0) return capacity_;
+
+		auto [h1, h2] = hash(key);
+		auto p = Probe{capacity_ / group_width - 1, h1 & (capacity_ / group_width - 1)};
+		while (true)
+		{
+			auto group = Group{ctrl_.data() + p.offset()};
+			for (auto mask = group.match(h2); mask; mask &= mask - 1)
+			{
+				auto index = p.offset() + flat_hash_detail::lowest_bit(mask);
+				if (equal_(slots_[index].first, key)) return index;
+			}
+			if (group.match(empty_slot)) return capacity_;
+			p.next();
+		}
+	}
+
+	struct Slot
+	{
+		size_t index;
+		Control h2;
+		bool found;
+	};
+
+	// slot of key, or the first empty slot on its probe sequence
+	Slot probe(K const& key) const
+	{
+		auto [h1, h2] = hash(key);
+		auto p = Probe{capacity_ / group_width - 1, h1 & (capacity_ / group_width - 1)};
+		while (true)
+		{
+			auto group = Group{ctrl_.data() + p.offset()};
+			for (auto mask = group.match(h2); mask; mask &= mask - 1)
+			{
+				auto index = p.offset() + flat_hash_detail::lowest_bit(mask);
+				if (equal_(slots_[index].first, key)) return {index, h2, true};
+			}
+			if (auto mask = group.match(empty_slot))
+				return {p.offset() + flat_hash_detail::lowest_bit(mask), h2, false};
+			p.next();
+		}
+	}
+
+	void rehash(size_t capacity)
+	{
+		auto old_ctrl = std::move(ctrl_);
+		auto old_slots = slots_;
+		auto old_capacity = capacity_;
+
+		ctrl_.assign(capacity, empty_slot);
+		slots_ = std::allocator<value_type>{}.allocate(capacity);
+		capacity_ = capacity;
+
+		for (size_t i = 0; i < old_capacity; ++i)
+		{
+			if (old_ctrl[i] == empty_slot) continue;
+
+			auto [index, h2, found] = probe(old_slots[i].first);
+			new (&slots_[index]) value_type(std::move(old_slots[i]));
+			ctrl_[index] = h2;
+			old_slots[i].~value_type();
+		}
+		if (old_slots) std::allocator<value_type>{}.deallocate(old_slots, old_capacity);
+	}
+
+	std::vector<Control> ctrl_;
+	value_type* slots_ = nullptr;
+	size_t capacity_ = 0;      // a power of two, multiple of group_width
+	size_t size_ = 0;
+	Hash hash_;
+	KeyEqual equal_;
+};
+
+template <typename K, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class flat_hash_multiset
+{
+public:
+	using key_type = K;
+	using value_type = K;
+	using size_type = size_t;
+
+	auto size() const { return size_; }
+	auto empty() const { return size_ == 0; }
+	auto unique_size() const { return counts_.size(); }
+
+	void reserve(size_t unique_keys) { counts_.reserve(unique_keys); }
+
+	void insert(K const& key)
+	{
+		++counts_[key];
+		++size_;
+	}
+
+	template <typename It>
+	void insert(It first, It last)
+	{
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+			typename std::iterator_traits<It>::iterator_category>)
+		{
+			reserve(unique_size() + size_t(std::distance(first, last)));
+		}
+		for (; first != last; ++first) insert(*first);
+	}
+
+	template <typename Q>
+	size_t count(Q const& key) const
+	{
+		auto pos = counts_.find(key);
+		return pos != counts_.end() ? pos->second : 0;
+	}
+
+	template <typename Q>
+	bool contains(Q const& key) const { return counts_.contains(key); }
+
+	// (key, number of copies)
+	auto begin() const { return counts_.begin(); }
+	auto end() const { return counts_.end(); }
+
+	auto memory_footprint() const { return counts_.memory_footprint(); }
+
+private:
+	flat_hash_map<K, size_t, Hash, KeyEqual> counts_;
+	size_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef GROWING_VECTOR_HPP
+#define GROWING_VECTOR_HPP
+
+// A push_back buffer with a selectable growth policy and telemetry.
+//
+// Growth policies: Factor2 (like most std::vector), Factor1_5, PageChunks<N> (linear, N pages).
+// Trivially copyable elements grow with realloc(); large buffers (Linux) live in
+// mmap'ed memory and grow with mremap(), which moves page table entries instead of bytes.
+// Both avoid holding old and new buffer at the same time when growing in place.
+// Other element types are moved into a new buffer like std::vector does.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+struct Factor2
+{
+	static constexpr auto name = "2x";
+	static size_t grow(size_t capacity, size_t needed, size_t) { return std::max(needed, 2 * capacity); }
+};
+
+struct Factor1_5
+{
+	static constexpr auto name = "1.5x";
+	static size_t grow(size_t capacity, size_t needed, size_t) { return std::max(needed, capacity + capacity / 2); }
+};
+
+template <size_t Pages = 16>
+struct PageChunks
+{
+	static constexpr auto name = "page chunks";
+	static constexpr size_t page_size = 4096;
+
+	static size_t grow(size_t capacity, size_t needed, size_t element_size)
+	{
+		auto bytes = std::max(needed, capacity + 1) * element_size + Pages * page_size - 1;
+		return bytes / (Pages * page_size) * (Pages * page_size) / element_size;
+	}
+};
+
+struct GrowthTelemetry
+{
+	size_t reallocations = 0;       // capacity changes
+	size_t in_place = 0;            // ... of which kept the address or remapped pages
+	size_t bytes_copied = 0;
+	size_t peak_wasted_bytes = 0;   // unused capacity right after growing
+	size_t peak_bytes = 0;          // largest footprint, old and new buffer during a copy
+};
+
+struct GrowthEvent
+{
+	size_t size, old_capacity, new_capacity;
+	void const* address;
+	bool in_place;
+};
+
+template <typename T, typename Policy = Factor2>
+class GrowingVector
+{
+	static constexpr bool relocatable = std::is_trivially_copyable_v<T>;
+#if defined(__linux__)
+	static constexpr size_t map_threshold = 1 << 20;   // bytes; larger buffers use mmap
+#endif
+
+public:
+	using value_type = T;
+
+	GrowingVector() = default;
+
+	GrowingVector(GrowingVector&& other) noexcept
+	: data_{std::exchange(other.data_, nullptr)}
+	, size_{std::exchange(other.size_, 0)}
+	, capacity_{std::exchange(other.capacity_, 0)}
+	, mapped_{std::exchange(other.mapped_, false)}
+	, telemetry_{other.telemetry_}
+	, hook_{std::move(other.hook_)}
+	{
+	}
+
+	GrowingVector& operator=(GrowingVector&& other) noexcept
+	{
+		GrowingVector{std::move(other)}.swap(*this);
+		return *this;
+	}
+
+	~GrowingVector()
+	{
+		clear();
+		release(data_, capacity_, mapped_);
+	}
+
+	void swap(GrowingVector& other) noexcept
+	{
+		using std::swap;
+		swap(data_, other.data_);
+		swap(size_, other.size_);
+		swap(capacity_, other.capacity_);
+		swap(mapped_, other.mapped_);
+		swap(telemetry_, other.telemetry_);
+		swap(hook_, other.hook_);
+	}
+
+	auto size() const { return size_; }
+	auto capacity() const { return capacity_; }
+	auto empty() const { return size_ == 0; }
+
+	T* data() { return data_; }
+	T const* data() const { return data_; }
+	T& operator[](size_t i) { return data_[i]; }
+	T const& operator[](size_t i) const { return data_[i]; }
+	T* begin() { return data_; }
+	T* end() { return data_ + size_; }
+	T const* begin() const { return data_; }
+	T const* end() const { return data_ + size_; }
+	T& back() { return data_[size_ - 1]; }
+
+	auto const& telemetry() const { return telemetry_; }
+
+	// called after every capacity change
+	void on_growth(std::function<void(GrowthEvent const&)> hook) { hook_ = std::move(hook); }
+
+	void reserve(size_t capacity)
+	{
+		if (capacity > capacity_) reallocate(capacity);
+	}
+
+	template <typename... Args>
+	T& emplace_back(Args&&... args)
+	{
+		if (size_ == capacity_) reallocate(Policy::grow(capacity_, size_ + 1, sizeof(T)));
+		auto p = new (data_ + size_) T(std::forward<Args>(args)...);
+		++size_;
+		return *p;
+	}
+
+	void push_back(T const& value) { emplace_back(value); }
+	void push_back(T&& value) { emplace_back(std::move(value)); }
+
+	void pop_back() { data_[--size_].~T(); }
+
+	void clear()
+	{
+		std::destroy(data_, data_ + size_);
+		size_ = 0;
+	}
+
+private:
+	void reallocate(size_t capacity)
+	{
+		auto old_data = data_;
+		auto old_capacity = capacity_;
+		auto old_bytes = capacity_ * sizeof(T);
+		auto bytes = capacity * sizeof(T);
+		auto in_place = false;
+
+		if constexpr (relocatable)
+		{
+#if defined(__linux__)
+			if (bytes >= map_threshold)
+			{
+				void* p = nullptr;
+				if (mapped_)
+				{
+					p = mremap(data_, old_bytes, bytes, MREMAP_MAYMOVE);
+					in_place = p != MAP_FAILED;
+				}
+				else
+				{
+					p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+					if (p != MAP_FAILED)
+					{
+						if (size_) std::memcpy(p, data_, size_ * sizeof(T));
+						std::free(data_);
+						telemetry_.bytes_copied += size_ * sizeof(T);
+						account(old_bytes + bytes);
+					}
+				}
+				if (p == MAP_FAILED) throw std::bad_alloc{};
+				data_ = static_cast<T*>(p);
+				mapped_ = true;
+			}
+			else
+#endif
+			{
+				auto p = std::realloc(data_, bytes);
+				if (!p) throw std::bad_alloc{};
+				in_place = p == data_;
+				if (!in_place && old_data)
+				{
+					telemetry_.bytes_copied += size_ * sizeof(T);
+					account(old_bytes + bytes);
+				}
+				data_ = static_cast<T*>(p);
+			}
+		}
+		else
+		{
+			auto p = static_cast<T*>(::operator new(bytes));
+			try
+			{
+				std::uninitialized_move(data_, data_ + size_, p);   // destroys its partial result on a throw
+			}
+			catch (...)
+			{
+				::operator delete(p);
+				throw;
+			}
+			std::destroy(data_, data_ + size_);
+			::operator delete(data_);
+			telemetry_.bytes_copied += size_ * sizeof(T);
+			account(old_bytes + bytes);
+			data_ = p;
+		}
+
+		capacity_ = capacity;
+		++telemetry_.reallocations;
+		if (in_place) ++telemetry_.in_place;
+		account(bytes);
+		telemetry_.peak_wasted_bytes = std::max(telemetry_.peak_wasted_bytes, (capacity_ - size_) * sizeof(T));
+
+		if (hook_) hook_(GrowthEvent{size_, old_capacity, capacity_, data_, in_place});
+	}
+
+	void account(size_t bytes)
+	{
+		telemetry_.peak_bytes = std::max(telemetry_.peak_bytes, bytes);
+	}
+
+	static void release(T* data, size_t capacity, bool mapped)
+	{
+		if (!data) return;
+#if defined(__linux__)
+		if (mapped)
+		{
+			munmap(data, capacity * sizeof(T));
+			return;
+		}
+#endif
+		if constexpr (relocatable) std::free(data);
+		else ::operator delete(data);
+	}
+
+	T* data_ = nullptr;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+	bool mapped_ = false;
+	GrowthTelemetry telemetry_;
+	std::function<void(GrowthEvent const&)> hook_;
+};
+
+#endif
@@ -1,13 +1,22 @@
+// list_capacity [--pool] [max_size]
+// --pool: list nodes come from a NodePool instead of the global heap
+
+#include <chrono>
 #include <iostream>
 #include <list>
+#include <string>
 
-int main()
-try
+#include "../benchmarking/rss.hpp"
+#include "node_pool.hpp"
+
+template <typename List>
+auto fill(List& v, size_t max_size)
 {
-	std::list<int> v;
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
 	auto c = v.size() / 1'000'000;
-	
-	while (true)
+
+	while (v.size() < max_size)
 	{
 		v.push_back(1);
 		if (c != v.size() / 1'000'000)
@@ -16,8 +25,33 @@ try
 			c = v.size() / 1'000'000;
 		}
 	}
+
+	auto diff = std::chrono::duration<double>(Clock::now() - start);
+	std::cout << v.size() << " push_backs : " << v.size() / diff.count() << " per s\n";
+}
+
+int main(int argc, char* argv[])
+try
+{
+	auto pooled = argc > 1 && argv[1] == std::string("--pool");
+	auto max_size = argc > 1 + pooled ? std::stoull(argv[1 + pooled]) : size_t(-1);
+
+	if (pooled)
+	{
+		NodePool pool;
+		std::list<int, PoolAllocator<int>> v{PoolAllocator<int>{pool}};
+		fill(v, max_size);
+		std::cout << "pool slabs  = " << pool.bytes_reserved() / (1024 * 1024) << " MiB\n";
+	}
+	else
+	{
+		std::list<int> v;
+		fill(v, max_size);
+	}
+	std::cout << "peak RSS    = " << bench::memory::peak_rss() / (1024 * 1024) << " MiB\n";
 }
 catch (std::exception& e)
 {
 	std::cerr << e.what() << '\n';
+	std::cerr << "peak RSS    = " << bench::memory::peak_rss() / (1024 * 1024) << " MiB\n";
 }
@@ -1,39 +1,139 @@
+// list_sort_bench [--pool] [--pattern name] [max_size]
+// --pool: list nodes come from a NodePool instead of the global heap
+// --pattern: sort only one input pattern (see sort_patterns.hpp)
+//
+// Sort results also show comparisons and element moves, counted with bench::Counted<int>.
+
 #include <algorithm>
-#include <chrono>
 #include <iostream>
-#include <random>
 #include <list>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/counted.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "../benchmarking/rss.hpp"
+#include "node_pool.hpp"
+#include "sort_patterns.hpp"
 
-auto random_sequence(size_t size)
+// the pool must outlive the list using it
+
+struct PooledList
 {
-	auto seq = std::list<int>(size);
+	NodePool pool;
+	std::pmr::list<int> seq{&pool};
+};
 
-	std::default_random_engine generator;
-	std::uniform_int_distribution<int> distribution(1,size);
+template <bool pooled>
+auto empty_list()
+{
+	if constexpr (pooled) return std::make_unique<PooledList>();
+	else return std::make_unique<std::list<int>>();
+}
 
-	std::generate(begin(seq), end(seq), 
-		[&]() { return distribution(generator); }
+template <typename List>
+auto& list_of(List& state)
+{
+	if constexpr (std::is_same_v<List, PooledList>) return state.seq;
+	else return state;
+}
+
+// setup copies the input of the current pattern and size instead of generating it again
+auto const& input(Pattern pattern, size_t size)
+{
+	return bench::cached([](Pattern p, size_t n) { return make_input(p, n); }, pattern, size);
+}
+
+template <bool pooled>
+auto make_list(Pattern pattern, size_t size)
+{
+	auto state = empty_list<pooled>();
+	auto& seq = list_of(*state);
+	for (auto value : input(pattern, size)) seq.push_back(value);
+	return state;
+}
+
+template <bool pooled>
+auto register_cases(std::vector<Pattern> const& patterns)
+{
+	auto name = std::string(pooled ? "pooled " : "") + "list<int>";
+	auto is_sorted = [](auto const& state)
+	{
+		auto const& seq = list_of(*state);
+		return std::is_sorted(begin(seq), end(seq));
+	};
+
+	bench::add("push_back " + name,
+		[](size_t size) { return std::pair{bench::random_values(size), empty_list<pooled>()}; },
+		[](auto& state)
+		{
+			auto& seq = list_of(*state.second);
+			for (auto value : state.first) seq.push_back(value);
+		},
+		[](auto const& state) { return list_of(*state.second).size() == state.first.size(); }
 	);
-	return seq;	
+	for (auto pattern : patterns)
+	{
+		bench::add("sort " + name + ' ' + ::name(pattern),
+			[pattern](size_t size) { return make_list<pooled>(pattern, size); },
+			[](auto& state) { list_of(*state).sort(); },
+			// [](auto& state) { std::sort(begin(list_of(*state)), end(list_of(*state))); },
+			is_sorted,
+			[pattern](size_t size)
+			{
+				auto const& values = input(pattern, size);
+				auto seq = std::list<bench::Counted<int>>(begin(values), end(values));
+				return bench::Counted<int>::count([&] { seq.sort(); });
+			}
+		);
+	}
 }
 
-int main()
+int main(int argc, char* argv[]) try
 {
-	size_t size = 10;
-	
-	while (size < 1'000'000'000)
+	auto pooled = false;
+	auto patterns = std::vector<Pattern>(std::begin(all_patterns), std::end(all_patterns));
+
+	// consume the options, bench::run expects [max_size] only
+	auto shift = [&](int n)
+	{
+		argv[n] = argv[0];
+		argc -= n;
+		argv += n;
+	};
+	while (argc > 1 && argv[1][0] == '-' && argv[1][1] == '-')
 	{
-		auto seq = random_sequence(size);
-		auto start = std::chrono::system_clock::now();
-        
-		seq.sort();
-		// std::sort(begin(seq), end(seq));
-		
-		auto end = std::chrono::system_clock::now();
-		auto diff = std::chrono::duration<double>(end-start);
-		std::cout << "Time to sort a list of " 
-				  << seq.size() << " ints : " << diff.count() << " s\n";
-	
-		size *= 10;
+		auto option = std::string(argv[1]);
+		if (option == "--pool")
+		{
+			pooled = true;
+			shift(1);
+		}
+		else if (option == "--pattern" && argc > 2)
+		{
+			auto it = std::find_if(begin(patterns), end(patterns), [&](auto p) { return name(p) == argv[2]; });
+			if (it == end(patterns)) throw std::invalid_argument(std::string("unknown pattern ") + argv[2]);
+			patterns = {*it};
+			shift(2);
+		}
+		else throw std::invalid_argument("unknown option " + option);
 	}
+
+	if (pooled) register_cases<true>(patterns);
+	else register_cases<false>(patterns);
+
+	auto status = bench::run(argc, argv);
+	std::cout << "peak RSS = " << bench::memory::peak_rss() / (1024 * 1024) << " MiB\n";
+	return status;
+}
+catch (std::exception const& e)
+{
+	std::cerr << e.what() << '\n';
+	return 1;
 }
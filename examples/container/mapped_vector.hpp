@@ -0,0 +1,151 @@
+#ifndef MAPPED_VECTOR_HPP
+#define MAPPED_VECTOR_HPP
+
+// A vector of trivially copyable elements stored in a memory-mapped file (POSIX).
+// The kernel pages data in and out of the file as needed,
+// so the vector may be larger than physical memory.
+// Growing extends the file and remaps it (mremap on Linux).
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+template <typename T>
+class MappedVector
+{
+	static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores raw bytes");
+
+public:
+	using value_type = T;
+
+	enum class Access { normal, sequential, random };
+
+	// opens (or creates) the file; existing contents become the elements
+	explicit MappedVector(std::filesystem::path path, bool remove_on_close = false)
+	: path_{std::move(path)}
+	, remove_{remove_on_close}
+	{
+		fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+		if (fd_ < 0) fail("open");
+
+		auto bytes = std::filesystem::file_size(path_);
+		size_ = bytes / sizeof(T);
+		if (size_) map(size_);
+	}
+
+	MappedVector(MappedVector const&) = delete;
+	MappedVector& operator=(MappedVector const&) = delete;
+
+	~MappedVector()
+	{
+		if (data_) ::munmap(data_, capacity_ * sizeof(T));
+		if (fd_ >= 0)
+		{
+			[[maybe_unused]] auto ok = ::ftruncate(fd_, off_t(size_ * sizeof(T)));  // drop unused capacity
+			::close(fd_);
+		}
+		if (remove_)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(path_, ignored);
+		}
+	}
+
+	auto size() const { return size_; }
+	auto capacity() const { return capacity_; }
+	auto empty() const { return size_ == 0; }
+	auto const& path() const { return path_; }
+
+	T* data() { return data_; }
+	T const* data() const { return data_; }
+	T& operator[](size_t i) { return data_[i]; }
+	T const& operator[](size_t i) const { return data_[i]; }
+	T* begin() { return data_; }
+	T* end() { return data_ + size_; }
+	T const* begin() const { return data_; }
+	T const* end() const { return data_ + size_; }
+
+	void reserve(size_t capacity)
+	{
+		if (capacity > capacity_) map(capacity);
+	}
+
+	void resize(size_t size)
+	{
+		reserve(size);
+		size_ = size;
+	}
+
+	void push_back(T const& value)
+	{
+		if (size_ == capacity_) reserve(std::max<size_t>(2 * capacity_, (1 << 20) / sizeof(T)));
+		data_[size_++] = value;
+	}
+
+	// tell the kernel how the data will be used: read-ahead and early eviction for sequential
+	void advise(Access access)
+	{
+		if (!data_) return;
+		auto advice = access == Access::sequential ? MADV_SEQUENTIAL
+		            : access == Access::random ? MADV_RANDOM : MADV_NORMAL;
+		::madvise(data_, capacity_ * sizeof(T), advice);
+	}
+
+	// transparent huge pages reduce TLB misses; Linux ignores this for most file systems
+	void use_huge_pages()
+	{
+#if defined(MADV_HUGEPAGE)
+		if (data_) ::madvise(data_, capacity_ * sizeof(T), MADV_HUGEPAGE);
+#endif
+	}
+
+	// write dirty pages back to the file
+	void flush()
+	{
+		if (data_ && ::msync(data_, size_ * sizeof(T), MS_SYNC) != 0) fail("msync");
+	}
+
+private:
+	[[noreturn]] void fail(char const* what) const
+	{
+		throw std::system_error(errno, std::generic_category(), std::string(what) + ' ' + path_.string());
+	}
+
+	void map(size_t capacity)
+	{
+		auto bytes = capacity * sizeof(T);
+		if (::ftruncate(fd_, off_t(bytes)) != 0) fail("ftruncate");
+
+		void* p = nullptr;
+#if defined(__linux__)
+		p = data_ ? ::mremap(data_, capacity_ * sizeof(T), bytes, MREMAP_MAYMOVE)
+		          : ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#else
+		if (data_) ::munmap(data_, capacity_ * sizeof(T));
+		p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#endif
+		if (p == MAP_FAILED) fail("mmap");
+		data_ = static_cast<T*>(p);
+		capacity_ = capacity;
+	}
+
+	std::filesystem::path path_;
+	bool remove_;
+	int fd_ = -1;
+	T* data_ = nullptr;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+
+#endif
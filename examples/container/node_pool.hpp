@@ -0,0 +1,149 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+// A pool for the many small, equally sized nodes of list, set, and map:
+// nodes are cut from large contiguous slabs, freed nodes are kept in
+// a free list per size class for reuse, and release() (or the destructor)
+// returns all slabs at once.
+//
+// NodePool is a std::pmr::memory_resource for std::pmr containers,
+// PoolAllocator<T> is a classic allocator for std::list<T, PoolAllocator<T>> etc.
+// Not thread-safe: use one pool per thread.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+class NodePool : public std::pmr::memory_resource
+{
+public:
+	explicit NodePool(size_t first_slab = 64 * 1024,
+		std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+	: next_slab_{first_slab}
+	, upstream_{upstream}
+	{
+	}
+
+	~NodePool() override { release(); }
+
+	NodePool(NodePool const&) = delete;
+	NodePool& operator=(NodePool const&) = delete;
+
+	// give back all slabs; every node handed out becomes invalid
+	void release()
+	{
+		for (auto [slab, size] : slabs_) upstream_->deallocate(slab, size, granularity);
+		slabs_.clear();
+		free_.fill(nullptr);
+		current_ = nullptr;
+		left_ = 0;
+		reserved_ = 0;
+	}
+
+	// bytes taken from upstream for slabs
+	auto bytes_reserved() const { return reserved_; }
+
+private:
+	static constexpr size_t granularity = alignof(std::max_align_t);
+	static constexpr size_t max_node = 256;   // larger requests go upstream directly
+	static constexpr size_t max_slab = 64 * 1024 * 1024;
+
+	struct FreeNode
+	{
+		FreeNode* next;
+	};
+
+	static size_t size_class(size_t bytes)
+	{
+		return (std::max(bytes, sizeof(FreeNode)) + granularity - 1) / granularity;
+	}
+
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		if (bytes > max_node || alignment > granularity) return upstream_->allocate(bytes, alignment);
+
+		auto c = size_class(bytes);
+		if (auto node = free_[c])
+		{
+			free_[c] = node->next;
+			return node;
+		}
+
+		auto size = c * granularity;
+		if (left_ < size)
+		{
+			current_ = static_cast<std::byte*>(upstream_->allocate(next_slab_, granularity));
+			slabs_.emplace_back(current_, next_slab_);
+			left_ = next_slab_;
+			reserved_ += next_slab_;
+			next_slab_ = std::min(2 * next_slab_, max_slab);
+		}
+		auto node = current_;
+		current_ += size;
+		left_ -= size;
+		return node;
+	}
+
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override
+	{
+		if (bytes > max_node || alignment > granularity)
+		{
+			upstream_->deallocate(p, bytes, alignment);
+			return;
+		}
+		auto c = size_class(bytes);
+		free_[c] = new (p) FreeNode{free_[c]};
+	}
+
+	bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	std::array<FreeNode*, max_node / granularity + 1> free_{};
+	std::vector<std::pair<std::byte*, size_t>> slabs_;
+	std::byte* current_ = nullptr;
+	size_t left_ = 0;
+	size_t reserved_ = 0;
+	size_t next_slab_;
+	std::pmr::memory_resource* upstream_;
+};
+
+template <typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	explicit PoolAllocator(NodePool& pool) noexcept : pool_{&pool} {}
+
+	template <typename U>
+	PoolAllocator(PoolAllocator<U> const& other) noexcept : pool_{other.pool()} {}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(pool_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		pool_->deallocate(p, n * sizeof(T), alignof(T));
+	}
+
+	NodePool* pool() const noexcept { return pool_; }
+
+	template <typename U>
+	friend bool operator==(PoolAllocator const& a, PoolAllocator<U> const& b) { return a.pool() == b.pool(); }
+
+	template <typename U>
+	friend bool operator!=(PoolAllocator const& a, PoolAllocator<U> const& b) { return a.pool() != b.pool(); }
+
+private:
+	NodePool* pool_;
+};
+
+#endif
@@ -1,37 +1,171 @@
 #include <algorithm>
-#include <chrono>
+#include <iomanip>
 #include <iostream>
-#include <random>
 #include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "../benchmarking/memory.hpp"
+#include "btree_multiset.hpp"
 
 auto random_sequence(size_t size)
 {
-	auto seq = std::multiset<int>();
+	return bench::random_values(size);
+}
+
+template <typename Set>
+auto insert_one_by_one(std::vector<int> const& values)
+{
+	auto seq = Set();
+	for (auto value : values) seq.insert(value);
+	return seq;
+}
+
+// std::multiset of the same input: every case must iterate over the same sequence
+auto const& expected(size_t size)
+{
+	return bench::cached([](size_t n)
+	{
+		auto values = random_sequence(n);
+		return std::multiset<int>(begin(values), end(values));
+	}, size);
+}
 
-	std::default_random_engine generator;
-	std::uniform_int_distribution<int> distribution(1,size);
-	
-	for (size_t i=0; i < size; ++i)
-		seq.insert(distribution(generator));
+template <typename Set>
+struct Inserted
+{
+	std::vector<int> values;
+	Set seq;
+};
 
-	return seq;	
+// insert(seq, values) is timed
+template <typename Set, typename Insert>
+void add(std::string const& name, Insert insert)
+{
+	auto setup = [](size_t size) { return Inserted<Set>{random_sequence(size), {}}; };
+	auto check = [](Inserted<Set> const& state)
+	{
+		auto const& reference = expected(state.values.size());
+		return std::equal(begin(state.seq), end(state.seq), begin(reference), end(reference));
+	};
+	bench::add(name, setup, [=](Inserted<Set>& state) { insert(state.seq, state.values); }, check);
 }
 
-int main()
-{
-	size_t size = 10;
-	
-	while (size < 1'000'000'000)
-	{
-		auto start = std::chrono::system_clock::now();
-        		
-		auto seq = random_sequence(size);
-		
-		auto end = std::chrono::system_clock::now();
-		auto diff = std::chrono::duration<double>(end-start);
-        std::cout << "Time to create a sorted multiset of " 
-                  << seq.size() << " ints : " << diff.count() << " s\n";
-	
-		size *= 10;
+// count and lower_bound against std::multiset where nodes split and the tree is rebuilt:
+// runs of duplicates across leaves, ascending and descending keys (splits at one edge),
+// a small batch (inserted one by one), a large batch (merged and rebuilt) and bulk loading
+bool same_as_multiset()
+{
+	auto ok = true;
+	auto same_at = [](btree_multiset<int> const& tree, std::multiset<int> const& reference, int key)
+	{
+		auto a = tree.lower_bound(key);
+		auto b = reference.lower_bound(key);
+		// count walks from lower_bound, so a lower_bound past the first equal value shows up here too
+		return tree.count(key) == reference.count(key)
+			&& (a == tree.end()) == (b == reference.end())
+			&& (a == tree.end() || *a == *b);
+	};
+	auto compare = [&](btree_multiset<int> const& tree, std::multiset<int> const& reference, char const* what)
+	{
+		auto good = tree.size() == reference.size()
+			&& std::equal(tree.begin(), tree.end(), reference.begin(), reference.end());
+		if (!reference.empty())
+			for (auto key = *reference.begin() - 1; good && key <= *reference.rbegin() + 1; ++key)
+				good = same_at(tree, reference, key);
+		if (!good) std::cerr << "btree_multiset differs from std::multiset: " << what << ", size " << reference.size() << '\n';
+		ok = ok && good;
+	};
+
+	auto const n = 20'000;
+	auto random = bench::Xoshiro256{7};
+	auto duplicates = std::vector<int>(n);
+	for (auto& x : duplicates) x = int(bench::bounded(random(), 100));
+	auto ascending = std::vector<int>(n);
+	for (int i = 0; i < n; ++i) ascending[i] = i;
+	auto descending = std::vector<int>(rbegin(ascending), rend(ascending));
+
+	for (auto [values, what] : {std::pair{&duplicates, "duplicates"}, {&ascending, "ascending"}, {&descending, "descending"}})
+	{
+		auto tree = btree_multiset<int>();
+		auto reference = std::multiset<int>();
+		for (auto x : *values)
+		{
+			tree.insert(x);
+			reference.insert(x);
+			for (auto key : {x - 1, x, x + 1})
+			{
+				if (same_at(tree, reference, key)) continue;
+				std::cerr << "btree_multiset differs from std::multiset: " << what << " at " << key << ", size " << reference.size() << '\n';
+				return false;
+			}
+			if (reference.size() % 1000 == 0) compare(tree, reference, what);
+		}
+
+		auto small = std::vector<int>(values->begin(), values->begin() + 100);
+		tree.insert(begin(small), end(small));
+		reference.insert(begin(small), end(small));
+		compare(tree, reference, "small batch");
+
+		tree.insert(values->begin(), values->end());
+		reference.insert(values->begin(), values->end());
+		compare(tree, reference, "large batch");
+
+		compare(btree_multiset<int>(values->begin(), values->end()),
+			std::multiset<int>(values->begin(), values->end()), "bulk load");
+	}
+	return ok;
+}
+
+// heap bytes per element held by the container built by create(values)
+
+template <typename Create>
+auto bytes_per_element(std::vector<int> const& values, Create create)
+{
+	auto before = bench::memory::snapshot();
+	auto seq = create(values);
+	auto after = bench::memory::snapshot();
+	bench::do_not_optimize(seq);
+	return double(after.live - before.live) / values.size();
+}
+
+int main(int argc, char* argv[])
+{
+	if (!same_as_multiset()) return 1;
+	std::cout << "btree_multiset: count and lower_bound as in std::multiset across splits and rebuilds\n\n";
+
+	auto one_by_one = [](auto& seq, std::vector<int> const& values) { for (auto value : values) seq.insert(value); };
+	add<std::multiset<int>>("std::multiset insert", one_by_one);
+	add<btree_multiset<int>>("btree_multiset insert", one_by_one);
+	add<btree_multiset<int>>("btree_multiset batch insert", [](auto& seq, std::vector<int> const& values)
+	{
+		auto half = begin(values) + values.size() / 2;
+		seq.insert(begin(values), half);
+		seq.insert(half, end(values));
+	});
+	add<btree_multiset<int>>("btree_multiset bulk load", [](auto& seq, std::vector<int> const& values)
+	{
+		seq = btree_multiset<int>(begin(values), end(values));
+	});
+
+	auto status = bench::run(argc, argv);
+
+	std::cout << "\nmemory footprint [bytes/element]\n"
+	          << "        size      multiset  btree insert    btree bulk\n";
+	for (auto size : bench::sizes(10, bench::max_size(argc, argv) + 1))
+	{
+		auto values = random_sequence(size);
+		std::cout << std::setw(12) << size << std::fixed << std::setprecision(1)
+			<< std::setw(14) << bytes_per_element(values, insert_one_by_one<std::multiset<int>>)
+			<< std::setw(14) << bytes_per_element(values, insert_one_by_one<btree_multiset<int>>)
+			<< std::setw(14) << bytes_per_element(values, [](auto const& v)
+				{
+					return btree_multiset<int>(begin(v), end(v));
+				})
+			<< '\n' << std::defaultfloat;
 	}
+	return status;
 }
@@ -0,0 +1,88 @@
+#ifndef SORT_PATTERNS_HPP
+#define SORT_PATTERNS_HPP
+
+// Input patterns for sort benchmarks: real data is rarely uniform random,
+// it is presorted, made of runs, or full of duplicates.
+//
+// The introsort killer is McIlroy's adversary ("A Killer Adversary for Quicksort"):
+// std::sort itself is run with a comparator that decides values lazily so that
+// every pivot is as bad as possible. The recorded values are a worst case
+// for this particular std::sort; other algorithms see a scrambled permutation.
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../benchmarking/random_data.hpp"
+
+enum class Pattern { random, sorted, reverse, organ_pipe, sawtooth, many_duplicates, introsort_killer };
+
+constexpr Pattern all_patterns[] = {
+	Pattern::random, Pattern::sorted, Pattern::reverse, Pattern::organ_pipe,
+	Pattern::sawtooth, Pattern::many_duplicates, Pattern::introsort_killer
+};
+
+inline std::string name(Pattern pattern)
+{
+	constexpr char const* names[] = {
+		"random", "sorted", "reverse", "organ-pipe", "sawtooth", "many-duplicates", "introsort-killer"
+	};
+	return names[int(pattern)];
+}
+
+inline auto introsort_killer(size_t size)
+{
+	auto gas = int(size);           // not decided yet, larger than every decided value
+	std::vector<int> values(size, gas);
+	std::vector<int> index(size);
+	std::iota(begin(index), end(index), 0);
+
+	int solid = 0;
+	int candidate = 0;
+	std::sort(begin(index), end(index), [&](int x, int y)
+	{
+		if (values[x] == gas && values[y] == gas)
+		{
+			// freeze one of two undecided elements to the smallest value left
+			if (x == candidate) values[x] = solid++;
+			else values[y] = solid++;
+		}
+		if (values[x] == gas) candidate = x;
+		else if (values[y] == gas) candidate = y;
+		return values[x] < values[y];
+	});
+	for (auto& v : values) if (v == gas) v = solid++;
+	return values;
+}
+
+inline auto make_input(Pattern pattern, size_t size)
+{
+	using bench::Distribution;
+
+	switch (pattern)
+	{
+	case Pattern::random: return bench::random_values(size);
+	case Pattern::sorted: return bench::random_values(size, Distribution::sorted);
+	case Pattern::reverse: return bench::random_values(size, Distribution::reverse);
+	case Pattern::many_duplicates: return bench::random_values(size, Distribution::few_unique);
+	case Pattern::introsort_killer: return introsort_killer(size);
+	default: break;
+	}
+
+	auto values = std::vector<int>(size);
+	if (pattern == Pattern::organ_pipe)
+	{
+		// 0 1 2 ... n/2 ... 2 1 0
+		for (size_t i = 0; i < size; ++i) values[i] = int(std::min(i, size - 1 - i));
+	}
+	else
+	{
+		// ascending runs of 1024, like merged log files
+		for (size_t i = 0; i < size; ++i) values[i] = int(i % 1024);
+	}
+	return values;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef SORTING_HPP
+#define SORTING_HPP
+
+// Sort engines to compare against std::sort:
+// * radix_sort           LSD radix sort for integral keys, O(n) per byte
+// * parallel_merge_sort  sort chunks on a work-stealing pool, then multiway merge in parallel
+// * parallel_std_sort    std::sort(std::execution::par_unseq, ...) if the library has it
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+#include "../concurrency/thread_pool.hpp"
+
+// LSD radix sort, one byte per pass; passes where all keys share a byte are skipped
+
+template <typename T>
+void radix_sort(std::vector<T>& data)
+{
+	static_assert(std::is_integral_v<T>, "radix_sort needs integral keys");
+	using Key = std::make_unsigned_t<T>;
+
+	// flip the sign bit, so that negative numbers come first
+	constexpr auto bias = std::is_signed_v<T> ? Key(Key{1} << (8 * sizeof(T) - 1)) : Key{0};
+	auto key = [](T x) { return Key(Key(x) ^ bias); };
+
+	std::vector<T> buffer(data.size());
+	auto* from = &data;
+	auto* to = &buffer;
+
+	for (size_t shift = 0; shift < 8 * sizeof(T); shift += 8)
+	{
+		std::array<size_t, 256> count{};
+		for (auto x : *from) ++count[(key(x) >> shift) & 0xFF];
+
+		if (std::find(begin(count), end(count), from->size()) != end(count)) continue;
+
+		size_t offset = 0;
+		for (auto& c : count) offset += std::exchange(c, offset);
+
+		for (auto x : *from) (*to)[count[(key(x) >> shift) & 0xFF]++] = x;
+		std::swap(from, to);
+	}
+	if (from != &data) data.swap(buffer);
+}
+
+// k-way merge of sorted runs [first_i, last_i) into out
+
+template <typename It, typename Out>
+void multiway_merge(std::vector<std::pair<It, It>> runs, Out out)
+{
+	runs.erase(std::remove_if(begin(runs), end(runs),
+		[](auto const& run) { return run.first == run.second; }), end(runs));
+
+	auto greater = [](auto const& a, auto const& b) { return *b.first < *a.first; };
+	std::make_heap(begin(runs), end(runs), greater);
+
+	while (!runs.empty())
+	{
+		std::pop_heap(begin(runs), end(runs), greater);
+		auto& run = runs.back();
+		*out++ = std::move(*run.first++);
+
+		if (run.first == run.second) runs.pop_back();
+		else std::push_heap(begin(runs), end(runs), greater);
+	}
+}
+
+template <typename T>
+void parallel_merge_sort(std::vector<T>& data, ThreadPool& pool, size_t min_chunk = 1 << 16)
+{
+	auto n = data.size();
+	auto chunks = std::min<size_t>(4 * pool.size(), std::max<size_t>(1, n / min_chunk));
+	if (chunks < 2)
+	{
+		std::sort(begin(data), end(data));
+		return;
+	}
+
+	// 1. sort chunks independently
+	parallel_for(pool, n, chunks, [&](size_t first, size_t last)
+	{
+		std::sort(begin(data) + first, begin(data) + last);
+	});
+
+	using It = typename std::vector<T>::iterator;
+	std::vector<std::pair<It, It>> runs;
+	for (size_t c = 0; c < chunks; ++c)
+		runs.emplace_back(begin(data) + n * c / chunks, begin(data) + n * (c + 1) / chunks);
+
+	// 2. splitters from a regular sample of all runs
+	std::vector<T> sample;
+	for (auto [first, last] : runs)
+		for (size_t i = 1; i < chunks; ++i)
+			sample.push_back(first[(last - first) * i / chunks]);
+	std::sort(begin(sample), end(sample));
+
+	std::vector<T> splitters;
+	for (size_t i = 1; i < chunks; ++i) splitters.push_back(sample[i * sample.size() / chunks]);
+
+	// 3. each output part merges the pieces of all runs between two splitters
+	auto bounds = std::vector<std::vector<It>>(chunks + 1);
+	for (auto [first, last] : runs)
+	{
+		bounds[0].push_back(first);
+		for (size_t s = 0; s < splitters.size(); ++s)
+			bounds[s + 1].push_back(std::lower_bound(first, last, splitters[s]));
+		bounds[chunks].push_back(last);
+	}
+
+	std::vector<T> result(n);
+	size_t offset = 0;
+	TaskGroup group{pool};
+	for (size_t part = 0; part < chunks; ++part)
+	{
+		std::vector<std::pair<It, It>> pieces;
+		size_t length = 0;
+		for (size_t r = 0; r < runs.size(); ++r)
+		{
+			pieces.emplace_back(bounds[part][r], bounds[part + 1][r]);
+			length += bounds[part + 1][r] - bounds[part][r];
+		}
+		auto out = begin(result) + offset;
+		offset += length;
+		group.run([pieces = std::move(pieces), out] { multiway_merge(pieces, out); });
+	}
+	group.wait();
+	data.swap(result);
+}
+
+#if defined(__cpp_lib_parallel_algorithm)
+template <typename T>
+void parallel_std_sort(std::vector<T>& data)
+{
+	std::sort(std::execution::par_unseq, begin(data), end(data));
+}
+#endif
+
+#endif
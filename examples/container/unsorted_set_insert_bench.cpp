@@ -1,37 +1,148 @@
+// g++ -std=c++17 -O2 -march=native unsorted_set_insert_bench.cpp
+// (-march=native or -mavx2 lets flat_hash probe 32 control bytes at once)
+
 #include <algorithm>
-#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <random>
+#include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "../benchmarking/memory.hpp"
+#include "flat_hash.hpp"
 
 auto random_sequence(size_t size)
 {
-	auto seq = std::unordered_multiset<int>();
+	return bench::random_values(size);
+}
+
+template <typename Set>
+auto insert_one_by_one(std::vector<int> const& values)
+{
+	auto seq = Set();
+	for (auto value : values) seq.insert(value);
+	return seq;
+}
+
+auto bulk_insert(std::vector<int> const& values)
+{
+	auto seq = flat_hash_multiset<int>();
+	seq.insert(begin(values), end(values));
+	return seq;
+}
+
+// std::unordered_multiset of the same input: every case must count each key as often
+auto const& expected(size_t size)
+{
+	return bench::cached([](size_t n)
+	{
+		auto values = random_sequence(n);
+		return std::unordered_multiset<int>(begin(values), end(values));
+	}, size);
+}
 
-	std::default_random_engine generator;
-	std::uniform_int_distribution<int> distribution(1,size);
-	
-	for (size_t i=0; i < size; ++i)
-		seq.insert(distribution(generator));
+template <typename Set>
+struct Inserted
+{
+	std::vector<int> values;
+	Set seq;
+};
 
-	return seq;	
+// the count of every input key as in the reference, and none of keys outside [1, size]
+template <typename Set>
+bool same_counts(Set const& seq, std::vector<int> const& values)
+{
+	auto const& reference = expected(values.size());
+	if (seq.size() != reference.size()) return false;
+	for (auto key : values)
+		if (seq.count(key) != reference.count(key)) return false;
+	auto const above = int(values.size()) + 1;
+	for (auto k = 0; k < 100; ++k)
+		if (seq.count(-k) != 0 || seq.count(above + k) != 0) return false;
+	return true;
 }
 
-int main()
+// insert(seq, values) is timed
+template <typename Set, typename Insert>
+void add(std::string const& name, Insert insert)
 {
-	size_t size = 10;
-	
-	while (size < 1'000'000'000)
+	auto setup = [](size_t size) { return Inserted<Set>{random_sequence(size), {}}; };
+	auto check = [](Inserted<Set> const& state) { return same_counts(state.seq, state.values); };
+	bench::add(name, setup, [=](Inserted<Set>& state) { insert(state.seq, state.values); }, check);
+}
+
+// a filled set and keys to look up: all present (hit) or all absent (miss)
+
+template <typename Set>
+struct Lookup
+{
+	Set seq;
+	std::vector<int> keys;
+	size_t found = 0;
+};
+
+template <typename Set, bool hit>
+auto lookup_setup(size_t size)
+{
+	auto values = random_sequence(size);
+	auto keys = values;
+	std::shuffle(begin(keys), end(keys), std::default_random_engine{42});
+	if (!hit) for (auto& key : keys) key = -key;
+
+	return Lookup<Set>{insert_one_by_one<Set>(values), keys};
+}
+
+template <typename Create>
+auto bytes_per_element(std::vector<int> const& values, Create create)
+{
+	auto before = bench::memory::snapshot();
+	auto seq = create(values);
+	auto after = bench::memory::snapshot();
+	bench::do_not_optimize(seq);
+	return double(after.live - before.live) / values.size();
+}
+
+int main(int argc, char* argv[])
+{
+	using StdSet = std::unordered_multiset<int>;
+	using FlatSet = flat_hash_multiset<int>;
+
+	auto one_by_one = [](auto& seq, std::vector<int> const& values) { for (auto value : values) seq.insert(value); };
+	add<StdSet>("unordered_multiset insert", one_by_one);
+	add<FlatSet>("flat_hash_multiset insert", one_by_one);
+	add<FlatSet>("flat_hash_multiset bulk", [](FlatSet& seq, std::vector<int> const& values)
+	{
+		seq.insert(begin(values), end(values));
+	});
+
+	auto look_up = [](auto& state)
+	{
+		for (auto key : state.keys) state.found += state.seq.count(key) != 0;
+	};
+	auto all_found = [](auto const& state) { return state.found == state.keys.size(); };
+	auto none_found = [](auto const& state) { return state.found == 0; };
+
+	bench::add("unordered_multiset hit", lookup_setup<StdSet, true>, look_up, all_found);
+	bench::add("flat_hash_multiset hit", lookup_setup<FlatSet, true>, look_up, all_found);
+	bench::add("unordered_multiset miss", lookup_setup<StdSet, false>, look_up, none_found);
+	bench::add("flat_hash_multiset miss", lookup_setup<FlatSet, false>, look_up, none_found);
+
+	auto status = bench::run(argc, argv);
+
+	std::cout << "\nmemory footprint [bytes/element]\n"
+	          << "        size    unordered    flat insert      flat bulk\n";
+	for (auto size : bench::sizes(10, bench::max_size(argc, argv) + 1))
 	{
-		auto start = std::chrono::system_clock::now();
-        		
-		auto seq = random_sequence(size);
-		
-		auto end = std::chrono::system_clock::now();
-		auto diff = std::chrono::duration<double>(end-start);
-		std::cout << "Time to create a unordered multiset of " 
-				  << seq.size() << " ints : " << diff.count() << " s\n";
-	
-		size *= 10;
+		auto values = random_sequence(size);
+		std::cout << std::setw(12) << size << std::fixed << std::setprecision(1)
+			<< std::setw(13) << bytes_per_element(values, insert_one_by_one<StdSet>)
+			<< std::setw(15) << bytes_per_element(values, insert_one_by_one<FlatSet>)
+			<< std::setw(15) << bytes_per_element(values, bulk_insert)
+			<< '\n' << std::defaultfloat;
 	}
+	return status;
 }
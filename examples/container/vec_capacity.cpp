@@ -1,25 +1,128 @@
+// vec_capacity [--summary] [max_size]
+// the same push_back stream into std::vector and GrowingVector with different growth policies:
+// one line per capacity change (size, old capacity, address of the data), then a summary table.
+// --summary: only the table
+
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <string>
 #include <vector>
 
-int main()
-try
+#include "growing_vector.hpp"
+
+struct Row
+{
+	std::string name;
+	size_t size;
+	double seconds;
+	GrowthTelemetry telemetry;
+};
+
+template <typename Vector>
+auto push_back_stream(Vector& v, size_t max_size)
+{
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+	try
+	{
+		while (v.size() < max_size) v.push_back(1);
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << " at size " << v.size() << '\n';
+	}
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void print(Row const& r)
+{
+	auto const& t = r.telemetry;
+	auto mib = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+	std::cout << std::left << std::setw(16) << r.name << std::right << std::fixed
+		<< std::setw(12) << r.size
+		<< std::setw(8) << t.reallocations
+		<< std::setw(10) << t.in_place
+		<< std::setprecision(1)
+		<< std::setw(12) << mib(t.bytes_copied)
+		<< std::setw(12) << mib(t.peak_wasted_bytes)
+		<< std::setw(12) << mib(t.peak_bytes)
+		<< std::setprecision(3)
+		<< std::setw(10) << r.seconds << '\n' << std::defaultfloat;
+}
+
+// std::vector gives no telemetry: watch capacity changes from outside
+auto run_std_vector(size_t max_size, bool events)
 {
+	if (events) std::cout << "std::vector\n";
 	std::vector<int> v;
+	auto t = GrowthTelemetry{};
 	auto s = v.size();
 	auto c = v.capacity();
-	
-	while (true)
+	auto seconds = 0.0;
 	{
-		v.push_back(1);
-		if (c != v.capacity())
+		using Clock = std::chrono::steady_clock;
+		auto start = Clock::now();
+		try
 		{
-			std::cout << s << ' ' << c << ' ' << &v.front() << '\n';
-			s = v.size();
-			c = v.capacity();
+			while (v.size() < max_size)
+			{
+				v.push_back(1);
+				if (c != v.capacity())
+				{
+					if (events) std::cout << s << ' ' << c << ' ' << &v.front() << '\n';
+					auto old_bytes = c * sizeof(int);
+					s = v.size();
+					c = v.capacity();
+					++t.reallocations;
+					t.bytes_copied += (v.size() - 1) * sizeof(int);
+					t.peak_wasted_bytes = std::max(t.peak_wasted_bytes, (c - v.size()) * sizeof(int));
+					t.peak_bytes = std::max(t.peak_bytes, old_bytes + c * sizeof(int));
+				}
+			}
 		}
+		catch (std::exception& e)
+		{
+			std::cerr << e.what() << " at size " << v.size() << '\n';
+		}
+		seconds = std::chrono::duration<double>(Clock::now() - start).count();
 	}
+	return Row{"std::vector", v.size(), seconds, t};
 }
-catch (std::exception& e)
+
+template <typename Policy>
+auto run(size_t max_size, bool events)
 {
-	std::cerr << e.what() << '\n';
+	GrowingVector<int, Policy> v;
+	if (events)
+	{
+		std::cout << '\n' << Policy::name << '\n';
+		v.on_growth([](GrowthEvent const& e)
+		{
+			std::cout << e.size << ' ' << e.old_capacity << ' ' << e.address << (e.in_place ? " in place\n" : "\n");
+		});
+	}
+	auto seconds = push_back_stream(v, max_size);
+	return Row{Policy::name, v.size(), seconds, v.telemetry()};
+}
+
+int main(int argc, char* argv[])
+{
+	auto events = !(argc > 1 && argv[1] == std::string("--summary"));
+	if (!events)
+	{
+		--argc;
+		++argv;
+	}
+	auto max_size = argc > 1 ? std::stoull(argv[1]) : size_t(100'000'000);
+
+	auto rows = std::vector<Row>{};
+	rows.push_back(run_std_vector(max_size, events));
+	rows.push_back(run<Factor2>(max_size, events));
+	rows.push_back(run<Factor1_5>(max_size, events));
+	rows.push_back(run<PageChunks<>>(max_size, events));
+
+	if (events) std::cout << '\n';
+	std::cout << "policy                  size  reallocs  in place  copied MiB  waste MiB   peak MiB    time s\n";
+	for (auto const& r : rows) print(r);
 }
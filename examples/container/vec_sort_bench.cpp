@@ -1,38 +1,137 @@
+// g++ -std=c++17 -O2 -pthread vec_sort_bench.cpp -ltbb
+// -ltbb only with libstdc++ 9 or later and the Intel TBB headers installed: its
+// std::execution::par_unseq then runs on TBB. Without them drop -ltbb, par_unseq runs sequentially.
+//
+// vec_sort_bench [--pattern name] [max_size]  in-memory sorts, all input patterns or one
+// vec_sort_bench --huge size [memory_mb]       external sort of a file-backed vector
+//
+// Results also show comparisons and element moves per sort, counted with bench::Counted<int>.
+
 #include <algorithm>
-#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <unistd.h>
 #include <vector>
 
-auto random_sequence(size_t size)
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/counted.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "external_sort.hpp"
+#include "mapped_vector.hpp"
+#include "sort_patterns.hpp"
+#include "sorting.hpp"
+
+// setup copies the input of the current pattern and size instead of generating it again
+auto const& input(Pattern pattern, size_t size)
+{
+	return bench::cached([](Pattern p, size_t n) { return make_input(p, n); }, pattern, size);
+}
+
+// what every sort must produce from it
+auto const& sorted_input(Pattern pattern, size_t size)
+{
+	return bench::cached([](Pattern p, size_t n)
+	{
+		auto values = input(p, n);
+		std::sort(begin(values), end(values));
+		return values;
+	}, pattern, size);
+}
+
+template <bool counted = true, typename Sort>
+void add_sort(std::string const& name, Pattern pattern, Sort sort)
+{
+	auto setup = [pattern](size_t size) { return input(pattern, size); };
+	auto is_sorted = [pattern](auto const& seq) { return seq == sorted_input(pattern, seq.size()); };
+	auto case_name = name + ' ' + ::name(pattern);
+
+	if constexpr (counted)
+	{
+		bench::add(case_name, setup, sort, is_sorted, [=](size_t size)
+		{
+			auto const& values = input(pattern, size);
+			auto seq = std::vector<bench::Counted<int>>(begin(values), end(values));
+			return bench::Counted<int>::count([&] { sort(seq); });
+		});
+	}
+	else bench::add(case_name, setup, sort, is_sorted);
+}
+
+// data larger than memory: generate into a mapped file, sort it with a memory budget
+int huge_sort(size_t size, size_t memory_bytes)
 {
-	auto seq = std::vector<int>(size);
+	auto dir = std::filesystem::temp_directory_path();
+	auto tag = std::to_string(::getpid());
+	auto input = dir / ("vec_sort_in" + tag + ".bin");
+	auto output = dir / ("vec_sort_out" + tag + ".bin");
+
+	{
+		auto seq = MappedVector<int>{input};
+		seq.resize(size);
+		seq.advise(MappedVector<int>::Access::sequential);
+		seq.use_huge_pages();
+		bench::fill(seq.data(), size);
+	}
 
-	std::default_random_engine generator;
-	std::uniform_int_distribution<int> distribution(1,size);
+	auto stats = external_sort<int>(input, output, memory_bytes, dir);
+	std::filesystem::remove(input);
 
-	std::generate(begin(seq), end(seq), 
-		[&]() { return distribution(generator); }
-	);
-	return seq;	
+	auto sorted = MappedVector<int>{output, true};
+	sorted.advise(MappedVector<int>::Access::sequential);
+	auto ok = sorted.size() == size && std::is_sorted(sorted.begin(), sorted.end());
+
+	auto mb = [](size_t bytes) { return bytes / 1e6; };
+	std::printf("elements      %zu\n", stats.elements);
+	std::printf("memory budget %.0f MB\n", mb(memory_bytes));
+	std::printf("runs          %zu\n", stats.runs);
+	std::printf("read          %.0f MB\n", mb(stats.bytes_read));
+	std::printf("written       %.0f MB\n", mb(stats.bytes_written));
+	std::printf("time          %.2f s\n", stats.seconds);
+	std::printf("throughput    %.1f MB/s\n", mb(stats.elements * sizeof(int)) / stats.seconds);
+	std::printf("sorted        %s\n", ok ? "yes" : "NO");
+	return ok ? 0 : 1;
 }
 
-int main()
+int main(int argc, char* argv[]) try
 {
-	size_t size = 10;
-	
-	while (size < 1'000'000'000)
+	if (argc > 2 && argv[1] == std::string("--huge"))
+	{
+		auto size = size_t(std::atof(argv[2]));
+		auto memory_mb = argc > 3 ? std::atof(argv[3]) : 256;
+		return huge_sort(size, size_t(memory_mb * (1 << 20)));
+	}
+
+	auto patterns = std::vector<Pattern>(std::begin(all_patterns), std::end(all_patterns));
+	if (argc > 2 && argv[1] == std::string("--pattern"))
 	{
-		auto seq = random_sequence(size);
-		auto start = std::chrono::system_clock::now();
-        		
-		std::sort(begin(seq), end(seq));
-		
-		auto end = std::chrono::system_clock::now();
-		auto diff = std::chrono::duration<double>(end-start);
-		std::cout << "Time to sort a vector of " 
-				  << size << " ints : " << diff.count() << " s\n";
-	
-		size *= 10;
+		auto it = std::find_if(begin(patterns), end(patterns), [&](auto p) { return name(p) == argv[2]; });
+		if (it == end(patterns)) throw std::invalid_argument(std::string("unknown pattern ") + argv[2]);
+		patterns = {*it};
+		argv[2] = argv[0];
+		argc -= 2;
+		argv += 2;
 	}
+
+	auto pool = ThreadPool{};
+
+	for (auto pattern : patterns)
+	{
+		add_sort("std::sort", pattern, [](auto& seq) { std::sort(begin(seq), end(seq)); });
+		// radix_sort does not compare and needs integral keys
+		add_sort<false>("radix_sort", pattern, [](auto& seq) { radix_sort(seq); });
+		add_sort("parallel_merge_sort", pattern, [&](auto& seq) { parallel_merge_sort(seq, pool); });
+#if defined(__cpp_lib_parallel_algorithm)
+		add_sort("std::sort(par_unseq)", pattern, [](auto& seq) { parallel_std_sort(seq); });
+#endif
+	}
+	return bench::run(argc, argv);
+}
+catch (std::exception const& e)
+{
+	std::cerr << e.what() << '\n';
+	return 1;
 }
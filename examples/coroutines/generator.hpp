@@ -0,0 +1,230 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+// generator<T>: a coroutine that co_yields values of type T, as a C++20 range.
+// * coroutine frames come from a FramePool per thread, which keeps freed frames for reuse
+// * co_yield elements_of(g) yields all elements of the generator g. The consumer always resumes
+//   the innermost running generator, and a finished one continues its parent directly,
+//   so an element costs the same at any nesting depth
+// * a generator is a move-only input view: iterate it once, or move it into a pipeline
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Freed frames, one list per size class of 64 bytes up to 4 KiB; larger frames use operator new.
+// A frame freed on another thread goes to the pool of that thread.
+class FramePool
+{
+public:
+	FramePool() = default;
+	FramePool(FramePool const&) = delete;
+	FramePool& operator=(FramePool const&) = delete;
+
+	~FramePool()
+	{
+		for (auto* frame : free_)
+		{
+			while (frame) ::operator delete(std::exchange(frame, frame->next));
+		}
+	}
+
+	void* allocate(size_t size)
+	{
+		auto c = size_class(size);
+		if (c >= classes) return ::operator new(size);
+		if (auto* frame = free_[c])
+		{
+			free_[c] = frame->next;
+			return frame;
+		}
+		return ::operator new(c * granularity);
+	}
+
+	void deallocate(void* p, size_t size)
+	{
+		auto c = size_class(size);
+		if (c >= classes) return ::operator delete(p);
+		free_[c] = new (p) Free{free_[c]};
+	}
+
+	static FramePool& local()
+	{
+		thread_local FramePool pool;
+		return pool;
+	}
+
+private:
+	struct Free
+	{
+		Free* next;
+	};
+
+	static constexpr size_t granularity = 64;
+	static constexpr size_t classes = 4096 / granularity + 1;
+
+	static size_t size_class(size_t size) { return (size + granularity - 1) / granularity; }
+
+	Free* free_[classes] = {};
+};
+
+template <typename T>
+class generator;
+
+// co_yield elements_of(g);
+template <typename T>
+struct elements_of
+{
+	explicit elements_of(generator<T>&& g) : nested{std::move(g)} {}
+
+	generator<T> nested;
+};
+
+template <typename T>
+class generator : public std::ranges::view_interface<generator<T>>
+{
+	static_assert(!std::is_reference_v<T>, "generator<T> yields T const&");
+
+public:
+	struct promise_type;
+	using handle = std::coroutine_handle<promise_type>;
+
+	struct promise_type
+	{
+		T const* value = nullptr;       // root: the element yielded last
+		handle leaf;                    // root: the innermost running generator
+		promise_type* root = this;
+		handle parent;                  // nested: the generator to continue when done
+		std::exception_ptr exception;
+
+		generator get_return_object()
+		{
+			leaf = handle::from_promise(*this);
+			return generator{leaf};
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+
+		auto final_suspend() noexcept
+		{
+			struct Final
+			{
+				bool await_ready() noexcept { return false; }
+				std::coroutine_handle<> await_suspend(handle h) noexcept
+				{
+					auto& p = h.promise();
+					if (!p.parent) return std::noop_coroutine();
+					p.root->leaf = p.parent;
+					return p.parent;
+				}
+				void await_resume() noexcept {}
+			};
+			return Final{};
+		}
+
+		// the temporary of co_yield {x, y, z} lives in the frame until the next resume
+		std::suspend_always yield_value(T const& x) noexcept
+		{
+			root->value = std::addressof(x);
+			return {};
+		}
+
+		auto yield_value(elements_of<T> elements) noexcept
+		{
+			struct Nested
+			{
+				generator nested;
+
+				bool await_ready() noexcept { return !nested.coroutine_; }
+				std::coroutine_handle<> await_suspend(handle h) noexcept
+				{
+					auto& child = nested.coroutine_.promise();
+					child.root = h.promise().root;
+					child.parent = h;
+					child.root->leaf = nested.coroutine_;
+					return nested.coroutine_;
+				}
+				void await_resume()
+				{
+					if (nested.coroutine_ && nested.coroutine_.promise().exception)
+						std::rethrow_exception(nested.coroutine_.promise().exception);
+				}
+			};
+			return Nested{std::move(elements.nested)};
+		}
+
+		void return_void() noexcept {}
+		void unhandled_exception() { exception = std::current_exception(); }
+
+		// only co_yield, no co_await
+		template <typename U>
+		std::suspend_never await_transform(U&&) = delete;
+
+		// root: run until the next element or the end
+		void resume()
+		{
+			leaf.resume();
+			if (exception) std::rethrow_exception(std::exchange(exception, {}));
+		}
+
+		static void* operator new(size_t size) { return FramePool::local().allocate(size); }
+		static void operator delete(void* p, size_t size) { FramePool::local().deallocate(p, size); }
+	};
+
+	class iterator
+	{
+	public:
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+		explicit iterator(handle coroutine) : coroutine_{coroutine} {}
+
+		T const& operator*() const { return *coroutine_.promise().value; }
+		iterator& operator++() { coroutine_.promise().resume(); return *this; }
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(iterator const& it, std::default_sentinel_t) { return !it.coroutine_ || it.coroutine_.done(); }
+
+	private:
+		handle coroutine_;
+	};
+
+	generator() = default;
+	generator(generator&& other) noexcept : coroutine_{std::exchange(other.coroutine_, {})} {}
+
+	generator& operator=(generator&& other) noexcept
+	{
+		if (this == &other) return *this;
+		if (coroutine_) coroutine_.destroy();
+		coroutine_ = std::exchange(other.coroutine_, {});
+		return *this;
+	}
+
+	~generator()
+	{
+		if (coroutine_) coroutine_.destroy();   // also the nested generators it is suspended in
+	}
+
+	// starts the coroutine, call once
+	iterator begin()
+	{
+		if (coroutine_) coroutine_.promise().resume();
+		return iterator{coroutine_};
+	}
+
+	std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+	explicit generator(handle coroutine) : coroutine_{coroutine} {}
+
+	handle coroutine_;
+};
+
+#endif
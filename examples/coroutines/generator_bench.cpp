@@ -0,0 +1,199 @@
+// g++ -std=c++20 -O2 -march=native generator_bench.cpp
+//
+// generator_bench [max_limit=800]
+// 1. The search of docs/44_coroutines.md for irreducible pythagorean triples with z < limit,
+//    written as a plain loop, with a callback, as a hand-written iterator and with generators
+//    (two stacked like in the docs, behind views::filter, one nested generator per z).
+//    All must find the same triples; allocations are counted per search.
+// 2. Nesting: elements yielded through 1, 10, 100 and 1000 levels of elements_of.
+
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <tuple>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/memory.hpp"
+#include "generator.hpp"
+
+using Triple = std::tuple<int, int, int>;
+
+bool irreducible(Triple const& t)
+{
+	auto [x, y, z] = t;
+	return std::gcd(x, z) == 1 && std::gcd(y, z) == 1;
+}
+
+// all searches add up the same summary
+struct Found
+{
+	long count = 0;
+	long sum = 0;
+
+	void add(Triple const& t)
+	{
+		auto [x, y, z] = t;
+		++count;
+		sum += x + 2 * y + 3 * z;
+	}
+
+	bool operator==(Found const&) const = default;
+};
+
+Found loop(int limit)
+{
+	Found found;
+	for (auto z = 1; z < limit; ++z)
+		for (auto y = 1; y < z; ++y)
+			for (auto x = 1; x < y; ++x)
+				if (x * x + y * y == z * z && irreducible({x, y, z})) found.add({x, y, z});
+	return found;
+}
+
+template <typename F>
+void pythagorean_triples(int limit, F f)
+{
+	for (auto z = 1; z < limit; ++z)
+		for (auto y = 1; y < z; ++y)
+			for (auto x = 1; x < y; ++x)
+				if (x * x + y * y == z * z) f(Triple{x, y, z});
+}
+
+// the loops turned inside out: ++ continues the search where the last triple was found
+class TripleIterator
+{
+public:
+	using value_type = Triple;
+	using difference_type = std::ptrdiff_t;
+
+	TripleIterator() = default;
+	explicit TripleIterator(int limit) : limit_{limit} { ++*this; }
+
+	Triple operator*() const { return {x_, y_, z_}; }
+
+	TripleIterator& operator++()
+	{
+		while (true)
+		{
+			if (++x_ >= y_)
+			{
+				x_ = 1;
+				if (++y_ >= z_)
+				{
+					y_ = 1;
+					if (++z_ >= limit_) return *this;
+				}
+			}
+			if (x_ * x_ + y_ * y_ == z_ * z_) return *this;
+		}
+	}
+
+	void operator++(int) { ++*this; }
+
+	friend bool operator==(TripleIterator const& it, std::default_sentinel_t) { return it.z_ >= it.limit_; }
+
+private:
+	int limit_ = 0;
+	int x_ = 0, y_ = 1, z_ = 1;
+};
+
+generator<Triple> pythagorean_triples(int limit)
+{
+	for (auto z = 1; z < limit; ++z)
+		for (auto y = 1; y < z; ++y)
+			for (auto x = 1; x < y; ++x)
+				if (x * x + y * y == z * z) co_yield {x, y, z};
+}
+
+generator<Triple> irreducible_pythagorean_triples(int limit)
+{
+	for (auto const& t : pythagorean_triples(limit))
+		if (irreducible(t)) co_yield t;
+}
+
+generator<Triple> with_hypotenuse(int z)
+{
+	for (auto y = 1; y < z; ++y)
+		for (auto x = 1; x < y; ++x)
+			if (x * x + y * y == z * z && irreducible({x, y, z})) co_yield {x, y, z};
+}
+
+generator<Triple> by_hypotenuse(int limit)
+{
+	for (auto z = 1; z < limit; ++z) co_yield elements_of(with_hypotenuse(z));
+}
+
+generator<int> numbers(int depth, int n)
+{
+	if (depth == 0)
+	{
+		for (auto i = 0; i < n; ++i) co_yield i;
+	}
+	else co_yield elements_of(numbers(depth - 1, n));
+}
+
+struct State
+{
+	int limit;
+	Found found;
+};
+
+template <typename Search>
+void add(std::string name, Search search)
+{
+	auto setup = [](size_t limit) { return State{int(limit), {}}; };
+	auto check = [](State const& state) { return state.found == loop(state.limit); };
+	auto count = [=](size_t limit)
+	{
+		auto before = bench::memory::snapshot();
+		auto state = setup(limit);
+		search(state);
+		auto after = bench::memory::snapshot();
+		return std::vector<std::pair<std::string, double>>{{"allocations", double(after.count - before.count)}};
+	};
+	bench::add(name, setup, search, check, count);
+}
+
+int main(int argc, char* argv[])
+{
+	auto last = bench::max_size(argc, argv, 800);
+
+	add("loop", [](State& s) { s.found = loop(s.limit); });
+	add("callback", [](State& s)
+	{
+		pythagorean_triples(s.limit, [&](Triple const& t) { if (irreducible(t)) s.found.add(t); });
+	});
+	add("iterator", [](State& s)
+	{
+		for (auto it = TripleIterator{s.limit}; it != std::default_sentinel; ++it)
+			if (irreducible(*it)) s.found.add(*it);
+	});
+	add("generator", [](State& s)
+	{
+		for (auto const& t : irreducible_pythagorean_triples(s.limit)) s.found.add(t);
+	});
+	add("generator | filter", [](State& s)
+	{
+		for (auto const& t : pythagorean_triples(s.limit) | std::views::filter(irreducible)) s.found.add(t);
+	});
+	add("nested per z", [](State& s)
+	{
+		for (auto const& t : by_hypotenuse(s.limit)) s.found.add(t);
+	});
+
+	bench::print_header();
+	for (auto limit : bench::sizes(100, last + 1, 2))
+		for (auto const& c : bench::registry()) bench::print(c.run(limit, {}));
+
+	auto const n = 1'000'000;
+	std::printf("\n%-12s %12s\n", "depth", "ns/element");
+	for (auto depth : {1, 10, 100, 1000})
+	{
+		auto result = bench::measure("numbers", n, [](size_t) { return 0L; }, [=](long& sum)
+		{
+			for (auto i : numbers(depth, n)) sum += i;
+		}, {}, [](long sum) { return sum == long(n) * (n - 1) / 2; });
+		std::printf("%-12d %12.3f\n", depth, result.median / n * 1e9);
+	}
+}
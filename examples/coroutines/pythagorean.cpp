@@ -0,0 +1,37 @@
+// g++ -std=c++20 pythagorean.cpp
+// the example of docs/44_coroutines.md with generator.hpp instead of <experimental/generator>
+
+#include <iostream>
+#include <numeric>
+#include <tuple>
+
+#include "generator.hpp"
+
+using Triple = std::tuple<int, int, int>;
+
+generator<Triple> pythagorean_triples(int limit)
+{
+	for (auto z = 1; z < limit; ++z)
+		for (auto y = 1; y < z; ++y)
+			for (auto x = 1; x < y; ++x)
+				if (x * x + y * y == z * z)
+				{
+					std::cout << '\t' << x << ' ' << y << ' ' << z << '\n';
+					co_yield {x, y, z};
+				}
+}
+
+generator<Triple> irreducible_pythagorean_triples(int limit)
+{
+	for (auto [x, y, z] : pythagorean_triples(limit))
+		if (std::gcd(x, z) == 1 && std::gcd(y, z) == 1)
+			co_yield {x, y, z};
+}
+
+int main()
+{
+	std::cout << "\tpythagorean triple\nirreducible\n";
+
+	for (auto [x, y, z] : irreducible_pythagorean_triples(30))
+		std::cout << x << ' ' << y << ' ' << z << '\n';
+}
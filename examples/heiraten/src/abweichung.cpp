@@ -0,0 +1,110 @@
+//: abweichung.cpp : abweichung() fuer viele Kandidaten auf einmal
+
+#include "abweichung.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+[[maybe_unused]] void skalar(Profil const& wunsch, int const* alter, double const* groesse, double const* vermoegen,
+            size_t n, double* ergebnis)
+{
+  for (size_t i = 0; i < n; ++i) ergebnis[i] = abweichung(wunsch, Profil(alter[i], groesse[i], vermoegen[i]));
+}
+
+} // namespace
+
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+
+namespace
+{
+
+// abweichung(a, b) je Spur: 0 fuer a == 0, sonst |(a-b)/a|; wie im Original
+// wird nur ein echt negativer Wert negiert (aus -0.0 wird nicht +0.0)
+__m512d abweichung(__m512d a, __m512d b)
+{
+  auto abw = _mm512_div_pd(_mm512_sub_pd(a, b), a);
+  auto negativ = _mm512_cmp_pd_mask(abw, _mm512_setzero_pd(), _CMP_LT_OQ);
+  abw = _mm512_mask_sub_pd(abw, negativ, _mm512_setzero_pd(), abw);
+  auto null = _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_EQ_OQ);
+  return _mm512_maskz_mov_pd(__mmask8(~null), abw);
+}
+
+} // namespace
+
+void abweichungen(Profil const& wunsch, int const* alter, double const* groesse, double const* vermoegen,
+                  size_t n, double* ergebnis)
+{
+  auto wa = _mm512_set1_pd(wunsch.alter);
+  auto wg = _mm512_set1_pd(wunsch.groesse);
+  auto wv = _mm512_set1_pd(wunsch.vermoegen);
+
+  for (size_t i = 0; i < n; i += 8)
+  {
+    // der Rest (weniger als 8) wird maskiert geladen und gespeichert
+    auto rest = __mmask8(n - i >= 8 ? 0xFF : (1u << (n - i)) - 1);
+    auto a = _mm512_maskz_cvtepi32_pd(rest, _mm256_maskz_loadu_epi32(rest, alter + i));
+    auto g = _mm512_maskz_loadu_pd(rest, groesse + i);
+    auto v = _mm512_maskz_loadu_pd(rest, vermoegen + i);
+
+    auto abw = _mm512_add_pd(abweichung(wa, a), abweichung(wg, g));
+    // das Vermoegen zaehlt nur, wenn es kleiner als gewuenscht ist
+    auto zu_arm = _mm512_cmp_pd_mask(wv, v, _CMP_GT_OQ);
+    abw = _mm512_mask_add_pd(abw, zu_arm, abw, abweichung(wv, v));
+
+    _mm512_mask_storeu_pd(ergebnis + i, rest, abw);
+  }
+}
+
+#elif defined(__AVX2__)
+
+namespace
+{
+
+__m256d abweichung(__m256d a, __m256d b)
+{
+  auto abw = _mm256_div_pd(_mm256_sub_pd(a, b), a);
+  auto negativ = _mm256_cmp_pd(abw, _mm256_setzero_pd(), _CMP_LT_OQ);
+  abw = _mm256_blendv_pd(abw, _mm256_sub_pd(_mm256_setzero_pd(), abw), negativ);
+  auto null = _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_EQ_OQ);
+  return _mm256_andnot_pd(null, abw);
+}
+
+} // namespace
+
+void abweichungen(Profil const& wunsch, int const* alter, double const* groesse, double const* vermoegen,
+                  size_t n, double* ergebnis)
+{
+  auto wa = _mm256_set1_pd(wunsch.alter);
+  auto wg = _mm256_set1_pd(wunsch.groesse);
+  auto wv = _mm256_set1_pd(wunsch.vermoegen);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    auto a = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<__m128i const*>(alter + i)));
+    auto g = _mm256_loadu_pd(groesse + i);
+    auto v = _mm256_loadu_pd(vermoegen + i);
+
+    auto abw = _mm256_add_pd(abweichung(wa, a), abweichung(wg, g));
+    // das Vermoegen zaehlt nur, wenn es kleiner als gewuenscht ist
+    auto zu_arm = _mm256_cmp_pd(wv, v, _CMP_GT_OQ);
+    abw = _mm256_blendv_pd(abw, _mm256_add_pd(abw, abweichung(wv, v)), zu_arm);
+
+    _mm256_storeu_pd(ergebnis + i, abw);
+  }
+  skalar(wunsch, alter + i, groesse + i, vermoegen + i, n - i, ergebnis + i);
+}
+
+#else
+
+void abweichungen(Profil const& wunsch, int const* alter, double const* groesse, double const* vermoegen,
+                  size_t n, double* ergebnis)
+{
+  skalar(wunsch, alter, groesse, vermoegen, n, ergebnis);
+}
+
+#endif
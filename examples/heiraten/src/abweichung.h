@@ -0,0 +1,65 @@
+//: abweichung.h : abweichung() fuer viele Kandidaten auf einmal
+
+#ifndef ABWEICHUNG_H
+#define ABWEICHUNG_H
+
+#include <cstddef>
+#include <vector>
+#include "single.h"
+
+// Profile spaltenweise (struct of arrays): ein Durchlauf ueber alle
+// Alter laedt nur Alter in den Cache, nicht Groesse, Vermoegen und Namen
+
+// dieselben Spalten, ohne sie zu besitzen: in Profile oder einem Abbild
+struct ProfilSpalten
+{
+  int const* alter = nullptr;
+  double const* groesse = nullptr;
+  double const* vermoegen = nullptr;
+  size_t n = 0;
+
+  auto size() const { return n; }
+  Profil operator[](size_t i) const { return Profil(alter[i], groesse[i], vermoegen[i]); }
+};
+
+struct Profile
+{
+  std::vector<int> alter;
+  std::vector<double> groesse;
+  std::vector<double> vermoegen;
+
+  auto size() const { return alter.size(); }
+
+  void push_back(Profil p)
+  {
+    alter.push_back(p.alter);
+    groesse.push_back(p.groesse);
+    vermoegen.push_back(p.vermoegen);
+  }
+
+  void setzen(size_t i, Profil p)
+  {
+    alter[i] = p.alter;
+    groesse[i] = p.groesse;
+    vermoegen[i] = p.vermoegen;
+  }
+
+  Profil operator[](size_t i) const { return Profil(alter[i], groesse[i], vermoegen[i]); }
+
+  ProfilSpalten spalten() const { return {alter.data(), groesse.data(), vermoegen.data(), size()}; }
+};
+
+// ergebnis[i] = abweichung(wunsch, Profil(alter[i], groesse[i], vermoegen[i])),
+// bitgenau wie die skalare Funktion. Mit AVX-512 (8 Kandidaten je Schritt) oder
+// AVX2 (4), wenn der Compiler es darf (-march=native), sonst skalar.
+// Die Faelle "Wunsch 0" und "Vermoegen nur, wenn zu klein" werden maskiert statt verzweigt.
+void abweichungen(Profil const& wunsch, int const* alter, double const* groesse, double const* vermoegen,
+                  size_t n, double* ergebnis);
+
+inline void abweichungen(Profil const& wunsch, Profile const& p, size_t anfang, size_t ende, double* ergebnis)
+{
+  abweichungen(wunsch, p.alter.data() + anfang, p.groesse.data() + anfang, p.vermoegen.data() + anfang,
+               ende - anfang, ergebnis);
+}
+
+#endif // ABWEICHUNG_H
@@ -0,0 +1,75 @@
+//: abweichung_bench.cpp : abweichung() einzeln und im Block
+// g++ -std=c++17 -O2 -march=native -pthread abweichung_bench.cpp abweichung.cpp single.cpp protokoll.cpp
+//
+// abweichung_bench [max_size=1e7]
+// Ein Wunschprofil gegen n Kandidaten: Schleife ueber abweichung(Profil, Profil)
+// gegen abweichungen() auf den Spalten. Beide Ergebnisse muessen bitgleich sein,
+// auch fuer die Sonderfaelle Wunsch 0, gleiches und groesseres Vermoegen.
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/random_data.hpp"
+#include "abweichung.h"
+
+Profile kandidaten(size_t n)
+{
+  bench::Xoshiro256 generator{n};
+  std::uniform_int_distribution<int> alter(18, 80);
+  std::normal_distribution<double> groesse(1.72, 0.09);
+  std::lognormal_distribution<double> vermoegen(10, 1.5);
+
+  Profile p;
+  for (size_t i = 0; i < n; ++i)
+  {
+    // jeder achte hat genau das gewuenschte Vermoegen
+    auto v = i % 8 == 3 ? 20000.0 : vermoegen(generator);
+    p.push_back(Profil(alter(generator), groesse(generator), v));
+  }
+  return p;
+}
+
+int main(int argc, char* argv[])
+{
+  auto max_size = bench::max_size(argc, argv, 10'000'000);
+  Profil wuensche[] = {Profil(40, 1.70, 20000), Profil(0, 1.80, 0), Profil(35, 0, 1e6)};
+
+  // Sonderfaelle und alle Reste (n % 8) gegen die skalare Funktion
+  for (size_t n = 0; n < 100; ++n)
+  {
+    auto p = kandidaten(n);
+    for (auto const& w : wuensche)
+    {
+      std::vector<double> skalar(n), block(n);
+      for (size_t i = 0; i < n; ++i) skalar[i] = abweichung(w, p[i]);
+      abweichungen(w, p, 0, n, block.data());
+      if (std::memcmp(skalar.data(), block.data(), n * sizeof(double)) != 0)
+        return std::printf("Fehler: abweichungen() weicht bei n = %zu ab\n", n), 1;
+    }
+  }
+
+  std::printf("%10s %14s %14s %14s %14s %9s\n", "Kandidaten", "einzeln [ns]", "Block [ns]",
+              "einzeln [1/s]", "Block [1/s]", "Faktor");
+  for (size_t n = 1000; n <= max_size; n *= 10)
+  {
+    auto p = kandidaten(n);
+    auto w = wuensche[0];
+    auto setup = [&](size_t) { return std::vector<double>(n); };
+
+    auto einzeln = bench::measure("einzeln", n, setup, [&](auto& ergebnis)
+    {
+      for (size_t i = 0; i < n; ++i) ergebnis[i] = abweichung(w, p[i]);
+    });
+    auto block = bench::measure("Block", n, setup, [&](auto& ergebnis)
+    {
+      abweichungen(w, p, 0, n, ergebnis.data());
+    });
+
+    auto ns = [&](bench::Result const& r) { return r.median / n * 1e9; };
+    std::printf("%10zu %14.2f %14.2f %14.3g %14.3g %9.1f\n", n, ns(einzeln), ns(block),
+                n / einzeln.median, n / block.median, einzeln.median / block.median);
+  }
+}
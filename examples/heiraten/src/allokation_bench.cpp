@@ -0,0 +1,115 @@
+//: allokation_bench.cpp : keine Heap-Allokation waehrend der Vermittlung
+// g++ -std=c++17 -O2 -march=native -pthread allokation_bench.cpp single.cpp protokoll.cpp sonder.cpp
+//
+// allokation_bench [singles=100000]
+// Zaehlt mit dem operator new aus memory.hpp, erst beim Aufbau der Singles,
+// dann in einer ganzen Vermittlung: jeder Mann bekommt 8 Frauen angeboten,
+// jede Frau 8 Maenner, dann die Bekanntgabe, mit dem Protokoll als Text und
+// als Spur nach /dev/null. Die Vermittlung muss ohne Allokation auskommen.
+// Die Namen sind laenger als die 15 Zeichen der small string optimization;
+// zum Vergleich dieselben Namenszugriffe als Kopie, wie name() sie frueher lieferte.
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/memory.hpp"
+#include "../../benchmarking/random_data.hpp"
+#include "protokoll.h"
+#include "single.h"
+#include "sonder.h"
+
+int main(int argc, char* argv[])
+{
+  using bench::memory::snapshot;
+  auto n = bench::max_size(argc, argv, 100'000);
+
+  // Aufbau: Singles und die Angebote, die sie bekommen
+  auto aufbau = snapshot();
+  bench::Xoshiro256 generator{n};
+  auto gleich = [&](double a, double b) { return a + (b - a) * bench::unit(generator()); };
+
+  std::vector<std::unique_ptr<Single>> alle;
+  std::vector<Single*> maenner, frauen;
+  alle.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    auto name = "Heiratskandidat Nr. " + std::to_string(i);
+    auto geschlecht = i % 2 ? 'w' : 'm';
+    auto eigen = Profil(int(gleich(18, 80)), gleich(1.55, 1.95), gleich(0, 200000));
+    auto wunsch = Profil(eigen.alter + int(gleich(-5, 5)), gleich(1.55, 1.95), gleich(0, 50000));
+    switch (bench::bounded(generator(), 20))
+    {
+    case 0:  alle.push_back(std::make_unique<AnspruchsvollerSingle>(name, geschlecht, eigen, wunsch)); break;
+    case 1:  alle.push_back(std::make_unique<BescheidenerSingle>(name, geschlecht, eigen, wunsch)); break;
+    case 2:  alle.push_back(std::make_unique<Heiratsschwindler>(name, geschlecht, eigen, wunsch)); break;
+    default: alle.push_back(std::make_unique<Single>(name, geschlecht, eigen, wunsch)); break;
+    }
+    (geschlecht == 'm' ? maenner : frauen).push_back(alle.back().get());
+  }
+
+  constexpr size_t je_single = 8;
+  std::vector<uint32_t> fuer_maenner(maenner.size() * je_single), fuer_frauen(frauen.size() * je_single);
+  for (auto& f : fuer_maenner) f = uint32_t(bench::bounded(generator(), frauen.size()));
+  for (auto& m : fuer_frauen) m = uint32_t(bench::bounded(generator(), maenner.size()));
+
+  std::ofstream null("/dev/null");
+  auto alt = std::cout.rdbuf(null.rdbuf());   // ausgabe() ohne Protokoll
+  auto nach_aufbau = snapshot();
+
+  auto vermitteln = [&]
+  {
+    for (size_t m = 0; m < maenner.size(); ++m)
+      for (size_t k = 0; k < je_single; ++k) maenner[m]->angebot(frauen[fuer_maenner[m * je_single + k]]);
+    for (size_t f = 0; f < frauen.size(); ++f)
+      for (size_t k = 0; k < je_single; ++k) frauen[f]->angebot(maenner[fuer_frauen[f * je_single + k]]);
+    for (auto& s : alle) s->ausgabe();
+    protokoll::leeren();
+  };
+
+  struct Zeile
+  {
+    char const* was;
+    bench::memory::Snapshot vorher, nachher;
+    double sekunden;
+  };
+  std::vector<Zeile> zeilen;
+  zeilen.reserve(4);
+  zeilen.push_back({"Aufbau der Singles", aufbau, nach_aufbau, 0});
+
+  for (auto format : {protokoll::Format::text, protokoll::Format::binaer})
+  {
+    protokoll::ziel(null, format);
+    auto vorher = snapshot();
+    auto sekunden = bench::seconds(vermitteln);
+    zeilen.push_back({format == protokoll::Format::text ? "Vermittlung, Protokoll als Text" : "Vermittlung, Protokoll als Spur",
+                      vorher, snapshot(), sekunden});
+  }
+
+  // je Angebot zwei Namen, wie in "Angebot:  a ?? b"
+  auto vorher = snapshot();
+  size_t laenge = 0;
+  for (size_t m = 0; m < maenner.size(); ++m)
+    for (size_t k = 0; k < je_single; ++k)
+      laenge += std::string(maenner[m]->name()).size() + std::string(frauen[fuer_maenner[m * je_single + k]]->name()).size();
+  zeilen.push_back({"nur Namen als std::string kopiert", vorher, snapshot(), 0});
+
+  protokoll::ziel(std::cout);
+  std::cout.rdbuf(alt);
+
+  std::printf("%zu Singles, %zu Angebote je Runde (%zu Zeichen Namen)\n\n", n, fuer_maenner.size() + fuer_frauen.size(), laenge);
+  std::printf("%-36s %14s %14s %10s\n", "", "Allokationen", "Bytes", "Zeit [s]");
+  auto fehler = false;
+  for (auto const& z : zeilen)
+  {
+    auto anzahl = z.nachher.count - z.vorher.count;
+    std::printf("%-36s %14zu %14zu %10.3f\n", z.was, anzahl, z.nachher.bytes - z.vorher.bytes, z.sekunden);
+    if (z.sekunden > 0 && anzahl != 0) fehler = true;
+  }
+  std::printf("\n%s\n", fehler ? "FEHLER: die Vermittlung hat Speicher angefordert" : "die Vermittlung fordert keinen Speicher an");
+  return fehler;
+}
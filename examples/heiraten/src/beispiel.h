@@ -0,0 +1,45 @@
+//: beispiel.h : Populationen fuer Tests und Benchmarks
+
+#ifndef BEISPIEL_H
+#define BEISPIEL_H
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include "../../benchmarking/random_data.hpp"
+#include "vermittlung.h"
+
+// die fuenf Singles aus output.txt
+inline Population beispiel()
+{
+  Population p;
+  p.hinzufuegen("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+  p.hinzufuegen("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+  p.hinzufuegen("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0), Art::schwindler);
+  p.hinzufuegen("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000), Art::anspruchsvoll);
+  p.hinzufuegen("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000), Art::bescheiden);
+  return p;
+}
+
+// zufaellige Singles: die Wuensche liegen in der Naehe des eigenen Profils
+inline Population zufaellig(size_t n, uint64_t seed = 0)
+{
+  bench::Xoshiro256 generator{seed ? seed : n};
+  std::uniform_int_distribution<int> alter(18, 80), abstand(-8, 8), art(0, 19);
+  std::normal_distribution<double> groesse(1.72, 0.09);
+  std::lognormal_distribution<double> vermoegen(10, 1.5);
+
+  Population p;
+  p.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    auto eigen = Profil(alter(generator), groesse(generator), vermoegen(generator));
+    auto wunsch = Profil(std::max(18, eigen.alter + abstand(generator)), groesse(generator), vermoegen(generator) / 4);
+    auto a = art(generator);   // 85% gewoehnlich, je 5% besondere
+    auto typ = a < 17 ? Art::gewoehnlich : Art(a - 16);
+    p.hinzufuegen("S" + std::to_string(i), i % 2 ? 'w' : 'm', eigen, wunsch, typ);
+  }
+  return p;
+}
+
+#endif // BEISPIEL_H
@@ -0,0 +1,314 @@
+//: bestand.cpp : Populationen laden und speichern
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "../../container/mapped_vector.hpp"
+#include "bestand.h"
+
+namespace
+{
+
+constexpr std::string_view arten[] = {"gewoehnlich", "anspruchsvoll", "bescheiden", "schwindler"};
+
+struct DateiSchliessen
+{
+  void operator()(std::FILE* f) const { std::fclose(f); }
+};
+
+using Datei = std::unique_ptr<std::FILE, DateiSchliessen>;
+
+Datei oeffnen(std::filesystem::path const& datei, char const* modus)
+{
+  auto f = Datei{std::fopen(datei.c_str(), modus)};
+  if (!f) throw std::system_error(errno, std::generic_category(), "kann " + datei.string() + " nicht oeffnen");
+  return f;
+}
+
+// ===[ CSV ]======================================================
+
+// die Felder einer Zeile der Reihe nach
+class Zeile
+{
+public:
+  Zeile(char const* anfang, char const* ende, size_t nummer, std::filesystem::path const& datei)
+  : pos_{anfang}, ende_{ende}, nummer_{nummer}, datei_{datei}
+  {
+  }
+
+  bool fertig() const { return pos_ > ende_; }
+
+  std::string_view feld()
+  {
+    if (fertig()) fehler("zu wenige Felder");
+    auto komma = static_cast<char const*>(std::memchr(pos_, ',', size_t(ende_ - pos_)));
+    auto ende = komma ? komma : ende_;
+    auto result = std::string_view(pos_, size_t(ende - pos_));
+    pos_ = ende + 1;
+    return result;
+  }
+
+  template <typename T>
+  T zahl()
+  {
+    auto text = feld();
+    T wert{};
+    auto [ende, fehlercode] = std::from_chars(text.data(), text.data() + text.size(), wert);
+    if (fehlercode != std::errc() || ende != text.data() + text.size())
+      fehler("keine Zahl: '" + std::string(text) + "'");
+    return wert;
+  }
+
+  [[noreturn]] void fehler(std::string const& was) const
+  {
+    throw std::runtime_error(datei_.string() + ':' + std::to_string(nummer_) + ": " + was);
+  }
+
+private:
+  char const* pos_;
+  char const* ende_;
+  size_t nummer_;
+  std::filesystem::path const& datei_;
+};
+
+void lesen(Population& p, Zeile z)
+{
+  auto name = z.feld();
+  auto geschlecht = z.feld();
+  if (geschlecht != "m" && geschlecht != "w") z.fehler("Geschlecht m oder w erwartet");
+
+  // einzeln, die Reihenfolge von Funktionsargumenten ist nicht festgelegt
+  auto profil = [&]
+  {
+    auto alter = z.zahl<int>();
+    auto groesse = z.zahl<double>();
+    return Profil(alter, groesse, z.zahl<double>());
+  };
+  auto eigen = profil();
+  auto wunsch = profil();
+
+  auto art = Art::gewoehnlich;
+  if (!z.fertig())
+  {
+    auto text = z.feld();
+    auto it = std::find(std::begin(arten), std::end(arten), text);
+    if (it == std::end(arten)) z.fehler("unbekannte Art '" + std::string(text) + "'");
+    art = Art(it - std::begin(arten));
+  }
+  if (!z.fertig()) z.fehler("zu viele Felder");
+
+  p.hinzufuegen(name, geschlecht[0], eigen, wunsch, art);
+}
+
+} // namespace
+
+Population csv_lesen(std::filesystem::path const& datei)
+{
+  auto f = oeffnen(datei, "rb");
+  Population p;
+  p.reserve(std::filesystem::file_size(datei) / 40);   // etwa 40 Bytes je Zeile
+
+  // blockweise lesen, die angefangene letzte Zeile wandert an den Anfang
+  std::vector<char> puffer(1 << 20);
+  size_t voll = 0, nummer = 0;
+  auto zeile = [&](char const* anfang, char const* ende)
+  {
+    ++nummer;
+    if (ende > anfang && ende[-1] == '\r') --ende;
+    auto text = std::string_view(anfang, size_t(ende - anfang));
+    if (text.empty() || text[0] == '#' || (nummer == 1 && text.substr(0, 5) == "name,")) return;
+    lesen(p, Zeile(anfang, ende, nummer, datei));
+  };
+
+  for (;;)
+  {
+    auto n = std::fread(puffer.data() + voll, 1, puffer.size() - voll, f.get());
+    if (std::ferror(f.get())) throw std::runtime_error("Lesefehler in " + datei.string());
+    voll += n;
+
+    char const* anfang = puffer.data();
+    auto ende = anfang + voll;
+    while (auto umbruch = static_cast<char const*>(std::memchr(anfang, '\n', size_t(ende - anfang))))
+    {
+      zeile(anfang, umbruch);
+      anfang = umbruch + 1;
+    }
+    if (n == 0)
+    {
+      if (anfang != ende) zeile(anfang, ende);
+      break;
+    }
+    voll = size_t(ende - anfang);
+    std::memmove(puffer.data(), anfang, voll);
+    if (voll == puffer.size()) puffer.resize(2 * puffer.size());   // sehr lange Zeile
+  }
+  return p;
+}
+
+void csv_schreiben(Population const& p, std::filesystem::path const& datei)
+{
+  auto f = oeffnen(datei, "wb");
+  std::string puffer;
+  puffer.reserve((1 << 20) + 256);
+
+  auto zahl = [&](auto wert)
+  {
+    char text[32];
+    auto ende = std::to_chars(text, text + sizeof(text), wert).ptr;   // kuerzeste exakte Form
+    puffer.append(text, ende);
+  };
+  auto profil = [&](Profil const& q)
+  {
+    zahl(q.alter);
+    puffer += ',';
+    zahl(q.groesse);
+    puffer += ',';
+    zahl(q.vermoegen);
+  };
+  auto leeren = [&]
+  {
+    if (std::fwrite(puffer.data(), 1, puffer.size(), f.get()) != puffer.size())
+      throw std::runtime_error("Schreibfehler in " + datei.string());
+    puffer.clear();
+  };
+
+  puffer += "name,geschlecht,alter,groesse,vermoegen,wunschalter,wunschgroesse,wunschvermoegen,art\n";
+  for (Population::Index i = 0; i < p.size(); ++i)
+  {
+    puffer += p.name(i);
+    puffer += ',';
+    puffer += p.geschlecht(i);
+    puffer += ',';
+    profil(p.eigen()[i]);
+    puffer += ',';
+    profil(p.wunsch()[i]);
+    if (p.art(i) != Art::gewoehnlich)
+    {
+      puffer += ',';
+      puffer += arten[int(p.art(i))];
+    }
+    puffer += '\n';
+    if (puffer.size() >= (1 << 20)) leeren();
+  }
+  leeren();
+}
+
+// ===[ Abbild ]===================================================
+
+namespace
+{
+
+enum Abschnitt
+{
+  name, geschlecht, art,
+  eigen_alter, eigen_groesse, eigen_vermoegen,
+  wunsch_alter, wunsch_groesse, wunsch_vermoegen,
+  namen_anfang, namen_zeichen,
+  abschnitte
+};
+
+constexpr char kennung[8] = {'s', 'i', 'n', 'g', 'l', 'e', 's', '1'};
+
+struct Kopf
+{
+  char kennung[8];
+  uint64_t singles, namen, zeichen;
+  uint64_t abschnitt[abschnitte];   // Anfang in Bytes
+  uint64_t groesse;                 // der ganzen Datei
+};
+
+constexpr uint64_t ausrichten(uint64_t n) { return (n + 63) / 64 * 64; }
+
+Kopf aufteilen(uint64_t singles, uint64_t namen, uint64_t zeichen)
+{
+  uint64_t const bytes[abschnitte] = {
+    singles * sizeof(Namen::Nummer), singles, singles,
+    singles * sizeof(int), singles * sizeof(double), singles * sizeof(double),
+    singles * sizeof(int), singles * sizeof(double), singles * sizeof(double),
+    (namen + 1) * sizeof(uint64_t), zeichen
+  };
+
+  Kopf kopf{};
+  std::memcpy(kopf.kennung, kennung, sizeof(kennung));
+  kopf.singles = singles;
+  kopf.namen = namen;
+  kopf.zeichen = zeichen;
+  auto pos = ausrichten(sizeof(Kopf));
+  for (int a = 0; a < abschnitte; ++a)
+  {
+    kopf.abschnitt[a] = pos;
+    pos = ausrichten(pos + bytes[a]);
+  }
+  kopf.groesse = pos;
+  return kopf;
+}
+
+} // namespace
+
+void abbild_schreiben(Population const& p, std::filesystem::path const& datei)
+{
+  auto const& s = p.spalten();
+  auto kopf = aufteilen(s.size, s.namen, s.namen_anfang[s.namen]);
+
+  std::filesystem::remove(datei);   // keine alten Bytes in den Luecken
+  MappedVector<char> abbild(datei);
+  abbild.resize(kopf.groesse);
+  abbild.advise(MappedVector<char>::Access::sequential);
+
+  auto kopieren = [&](Abschnitt a, void const* daten, size_t bytes)
+  {
+    if (bytes) std::memcpy(abbild.data() + kopf.abschnitt[a], daten, bytes);
+  };
+  auto n = s.size;
+  std::memcpy(abbild.data(), &kopf, sizeof(kopf));
+  kopieren(name, s.name, n * sizeof(Namen::Nummer));
+  kopieren(geschlecht, s.geschlecht, n);
+  kopieren(art, s.art, n);
+  kopieren(eigen_alter, s.eigen.alter, n * sizeof(int));
+  kopieren(eigen_groesse, s.eigen.groesse, n * sizeof(double));
+  kopieren(eigen_vermoegen, s.eigen.vermoegen, n * sizeof(double));
+  kopieren(wunsch_alter, s.wunsch.alter, n * sizeof(int));
+  kopieren(wunsch_groesse, s.wunsch.groesse, n * sizeof(double));
+  kopieren(wunsch_vermoegen, s.wunsch.vermoegen, n * sizeof(double));
+  kopieren(namen_anfang, s.namen_anfang, (s.namen + 1) * sizeof(uint64_t));
+  kopieren(namen_zeichen, s.namen_zeichen, kopf.zeichen);
+}
+
+Population abbild_laden(std::filesystem::path const& datei)
+{
+  // MappedVector legt fehlende Dateien an
+  if (!std::filesystem::exists(datei)) throw std::runtime_error(datei.string() + " gibt es nicht");
+  auto abbild = std::make_shared<MappedVector<char>>(datei);
+
+  Kopf kopf;
+  if (abbild->size() < sizeof(kopf)) throw std::runtime_error(datei.string() + " ist kein Abbild");
+  std::memcpy(&kopf, abbild->data(), sizeof(kopf));
+  auto erwartet = aufteilen(kopf.singles, kopf.namen, kopf.zeichen);
+  if (std::memcmp(&kopf, &erwartet, sizeof(kopf)) != 0 || abbild->size() != kopf.groesse)
+    throw std::runtime_error(datei.string() + " ist kein Abbild");
+
+  auto basis = abbild->data();
+  auto bei = [&](Abschnitt a) { return basis + kopf.abschnitt[a]; };
+  auto n = size_t(kopf.singles);
+
+  Population::Spalten s;
+  s.size = n;
+  s.name = reinterpret_cast<Namen::Nummer const*>(bei(name));
+  s.geschlecht = bei(geschlecht);
+  s.art = reinterpret_cast<Art const*>(bei(art));
+  s.eigen = {reinterpret_cast<int const*>(bei(eigen_alter)), reinterpret_cast<double const*>(bei(eigen_groesse)),
+             reinterpret_cast<double const*>(bei(eigen_vermoegen)), n};
+  s.wunsch = {reinterpret_cast<int const*>(bei(wunsch_alter)), reinterpret_cast<double const*>(bei(wunsch_groesse)),
+              reinterpret_cast<double const*>(bei(wunsch_vermoegen)), n};
+  s.namen_anfang = reinterpret_cast<uint64_t const*>(bei(namen_anfang));
+  s.namen_zeichen = bei(namen_zeichen);
+  s.namen = size_t(kopf.namen);
+  return Population(s, std::move(abbild));
+}
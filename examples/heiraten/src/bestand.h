@@ -0,0 +1,26 @@
+//: bestand.h : Populationen laden und speichern
+
+#ifndef BESTAND_H
+#define BESTAND_H
+
+#include <filesystem>
+#include "vermittlung.h"
+
+// CSV, eine Zeile je Single, die Art darf fehlen (gewoehnlich):
+//   name,geschlecht,alter,groesse,vermoegen,wunschalter,wunschgroesse,wunschvermoegen[,art]
+//   Anton,m,55,1.75,100000,50,1.7,0
+//   Claus,m,30,1.8,100000,25,1.7,0,schwindler
+// Leere Zeilen, Zeilen mit # und eine Kopfzeile "name,..." werden uebersprungen.
+// Zahlen liest std::from_chars ohne Locale und ohne Kopie der Zeile;
+// Fehler melden Datei und Zeile als std::runtime_error.
+Population csv_lesen(std::filesystem::path const& datei);
+void csv_schreiben(Population const& p, std::filesystem::path const& datei);
+
+// Abbild: alle Spalten der Population, auf 64 Bytes ausgerichtet, in der
+// Byte-Reihenfolge der Maschine. abbild_laden() bildet die Datei nur in den
+// Speicher ab (MappedVector) und liest die Spalten direkt von dort; erst der
+// Zugriff laedt Seiten. Die Datei wird nicht geprueft, nur ihr Kopf.
+void abbild_schreiben(Population const& p, std::filesystem::path const& datei);
+Population abbild_laden(std::filesystem::path const& datei);
+
+#endif // BESTAND_H
@@ -0,0 +1,70 @@
+//: bestand_bench.cpp : CSV und Abbild fuer grosse Populationen
+// g++ -std=c++17 -O2 -march=native -pthread bestand_bench.cpp bestand.cpp namen.cpp vermittlung.cpp profilindex.cpp abweichung.cpp single.cpp protokoll.cpp
+//
+// bestand_bench [max_size=1e6] [verzeichnis=temp_directory_path()]
+// fuer 10^4 .. max_size zufaellige Singles: CSV schreiben und lesen, Abbild
+// schreiben und laden; beide geladenen Populationen muessen der erzeugten
+// gleichen, bis 10^5 auch in der Vermittlung
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/rss.hpp"
+#include "beispiel.h"
+#include "bestand.h"
+#include "vermittlung.h"
+
+bool gleich(Population const& a, Population const& b)
+{
+  if (a.size() != b.size()) return false;
+  for (Population::Index i = 0; i < a.size(); ++i)
+  {
+    auto pa = a.eigen()[i], pb = b.eigen()[i], wa = a.wunsch()[i], wb = b.wunsch()[i];
+    if (a.name(i) != b.name(i) || a.geschlecht(i) != b.geschlecht(i) || a.art(i) != b.art(i)
+        || pa.alter != pb.alter || pa.groesse != pb.groesse || pa.vermoegen != pb.vermoegen
+        || wa.alter != wb.alter || wa.groesse != wb.groesse || wa.vermoegen != wb.vermoegen)
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  auto max_size = bench::max_size(argc, argv, 1'000'000);
+  auto verzeichnis = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::temp_directory_path();
+  auto csv = verzeichnis / "bestand_bench.csv";
+  auto abbild = verzeichnis / "bestand_bench.singles";
+
+  std::printf("%10s %9s %11s %11s %11s %9s %11s %11s %7s\n", "Singles", "CSV [MB]", "schreiben",
+              "lesen [s]", "Singles/s", "Abbild", "schreiben", "laden [us]", "gleich");
+  auto fehler = false;
+  for (size_t n = 10'000; n <= max_size; n *= 10)
+  {
+    auto p = zufaellig(n);
+
+    Population aus_csv, aus_abbild;
+    auto csv_aus = bench::seconds([&] { csv_schreiben(p, csv); });
+    auto csv_ein = bench::seconds([&] { aus_csv = csv_lesen(csv); });
+    auto abbild_aus = bench::seconds([&] { abbild_schreiben(p, abbild); });
+    auto abbild_ein = bench::seconds([&] { aus_abbild = abbild_laden(abbild); });
+
+    auto ok = gleich(p, aus_csv) && gleich(p, aus_abbild);
+    if (ok && n <= 100'000)
+    {
+      auto erwartet = vermitteln(p);
+      ok = vermitteln(aus_csv).partner == erwartet.partner && vermitteln(aus_abbild).partner == erwartet.partner;
+    }
+    fehler |= !ok;
+
+    std::printf("%10zu %9.1f %11.3f %11.3f %11.3g %9.1f %11.3f %11.1f %7s\n", n,
+                std::filesystem::file_size(csv) / 1e6, csv_aus, csv_ein, n / csv_ein,
+                std::filesystem::file_size(abbild) / 1e6, abbild_aus, 1e6 * abbild_ein, ok ? "ja" : "NEIN");
+  }
+  std::filesystem::remove(csv);
+  std::filesystem::remove(abbild);
+  std::printf("peak RSS = %zu MiB\n", bench::memory::peak_rss() / (1024 * 1024));
+  return fehler;
+}
@@ -0,0 +1,29 @@
+//: heiraten.cpp : Partnervermittlung
+// g++ -std=c++17 -pthread heiraten.cpp single.cpp protokoll.cpp sonder.cpp
+// mit -DHEIRATEN_PROTOKOLL=0 ohne Angebote und Trennungen, nur die Paare
+
+#include <vector>
+#include "single.h"
+#include "sonder.h"
+
+int main()
+{
+  Single anton("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+  Single berta("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+  Heiratsschwindler claus("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0));
+  AnspruchsvollerSingle doris("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000));
+  BescheidenerSingle ernst("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000));
+
+  std::vector<Single*> maenner{&anton, &claus, &ernst};
+  std::vector<Single*> frauen{&berta, &doris};
+
+  // jedem Mann alle Frauen anbieten, dann jeder Frau alle Maenner
+  for (auto m : maenner)
+    for (auto f : frauen) m->angebot(f);
+
+  for (auto f : frauen)
+    for (auto m : maenner) f->angebot(m);
+
+  for (auto m : maenner) m->ausgabe();
+  for (auto f : frauen) f->ausgabe();
+}
@@ -0,0 +1,194 @@
+//: nachvermittlung.cpp : eine Paarung aktuell halten, waehrend sich Profile aendern
+
+#include <algorithm>
+#include "nachvermittlung.h"
+
+Nachvermittlung::Nachvermittlung(Population p, Optionen const& optionen)
+: p_{std::move(p)}
+, optionen_{optionen}
+, paarung_{vermitteln(p_, optionen)}
+{
+  aufbauen('m');
+  aufbauen('w');
+}
+
+Nachvermittlung::Nachvermittlung(Population p, Paarung paarung, Optionen const& optionen)
+: p_{std::move(p)}
+, optionen_{optionen}
+, paarung_{std::move(paarung)}
+{
+  aufbauen('m');
+  aufbauen('w');
+}
+
+void Nachvermittlung::aufbauen(char geschlecht)
+{
+  auto& s = seite(geschlecht);
+  s.nach_vermoegen.clear();
+  s.schwindler.clear();
+  for (Index i = 0; i < p_.size(); ++i)
+  {
+    if (p_.geschlecht(i) != geschlecht) continue;
+    if (p_.art(i) == Art::schwindler) s.schwindler.emplace_back(p_.eigen().groesse[i], i);
+    else s.nach_vermoegen.emplace(-p_.eigen().vermoegen[i], i);
+  }
+  std::sort(begin(s.schwindler), end(s.schwindler));
+  indizieren(s);
+}
+
+void Nachvermittlung::indizieren(Seite& s)
+{
+  std::vector<Profil> profile;
+  std::vector<Index> indizes;
+  profile.reserve(s.nach_vermoegen.size());
+  indizes.reserve(s.nach_vermoegen.size());
+  for (auto [vermoegen, i] : s.nach_vermoegen)
+  {
+    profile.push_back(p_.eigen()[i]);
+    indizes.push_back(i);
+  }
+  s.index = ProfilIndex(profile, indizes);
+  s.aenderungen = 0;
+}
+
+// wie die Praeferenzlisten in vermitteln()
+void Nachvermittlung::kandidaten(Index a, Kandidaten& ergebnis, Kandidaten& beste) const
+{
+  auto const& s = seite(p_.geschlecht(a) == 'm' ? 'w' : 'm');
+  auto k = optionen_.praeferenzen;
+  ergebnis.clear();
+
+  auto pruefen = [&](Index e)
+  {
+    auto profil = p_.gesehen(a, e);
+    if (p_.akzeptiert(a, profil)) ergebnis.emplace_back(p_.bewertung(a, profil), e);
+  };
+
+  if (p_.art(a) == Art::schwindler)
+  {
+    for (auto it = begin(s.nach_vermoegen); it != end(s.nach_vermoegen) && ergebnis.size() < k; ++it)
+      pruefen(it->second);
+    for (size_t j = 0; j < s.schwindler.size() && j < k; ++j) pruefen(s.schwindler[j].second);
+  }
+  else
+  {
+    s.index.beste(p_.wunsch()[a], toleranz(p_.art(a)), k, beste);
+    ergebnis.assign(begin(beste), end(beste));
+
+    auto wg = p_.wunsch().groesse[a];
+    auto rechts = size_t(std::lower_bound(begin(s.schwindler), end(s.schwindler), std::pair{wg, Index(0)})
+                         - begin(s.schwindler));
+    auto links = rechts;
+    for (size_t n = 0; n < k; ++n)
+    {
+      auto links_ok = links > 0;
+      auto rechts_ok = rechts < s.schwindler.size();
+      if (!links_ok && !rechts_ok) break;
+      if (links_ok && (!rechts_ok || wg - s.schwindler[links - 1].first <= s.schwindler[rechts].first - wg))
+        pruefen(s.schwindler[--links].second);
+      else
+        pruefen(s.schwindler[rechts++].second);
+    }
+  }
+
+  auto n = std::min(ergebnis.size(), k);
+  std::partial_sort(begin(ergebnis), begin(ergebnis) + n, end(ergebnis));
+  ergebnis.resize(n);
+}
+
+Population::Index Nachvermittlung::blockierend(Index a, Kandidaten& kandidaten, Kandidaten& beste,
+                                               size_t& pruefungen) const
+{
+  auto const& partner = paarung_.partner;
+  this->kandidaten(a, kandidaten, beste);
+  for (auto const& [bewertung, z] : kandidaten)
+  {
+    ++pruefungen;
+    // aufsteigend nach Bewertung: ab dem eigenen Partner ist keiner mehr besser
+    if (z == partner[a] || (partner[a] != Paarung::kein && !p_.besser(a, z, partner[a]))) break;
+    if (!p_.akzeptiert(z, a)) continue;
+    if (partner[z] == Paarung::kein || p_.besser(z, a, partner[z])) return z;
+  }
+  return Paarung::kein;
+}
+
+void Nachvermittlung::trennen(Index a)
+{
+  auto& partner = paarung_.partner;
+  partner[partner[a]] = Paarung::kein;
+  partner[a] = Paarung::kein;
+  --paarung_.paare;
+  ++zaehler_.getrennt;
+}
+
+void Nachvermittlung::aendern(Index i, Profil eigen, Profil wunsch)
+{
+  ++zaehler_.aenderungen;
+  auto& s = seite(p_.geschlecht(i));
+  auto alt = p_.eigen()[i];
+  p_.aendern(i, eigen, wunsch);
+
+  if (p_.art(i) == Art::schwindler)
+  {
+    s.schwindler.erase(std::lower_bound(begin(s.schwindler), end(s.schwindler), std::pair{alt.groesse, i}));
+    auto neu = std::pair{eigen.groesse, i};
+    s.schwindler.insert(std::upper_bound(begin(s.schwindler), end(s.schwindler), neu), neu);
+  }
+  else
+  {
+    s.nach_vermoegen.erase({-alt.vermoegen, i});
+    s.nach_vermoegen.emplace(-eigen.vermoegen, i);
+    // die Quader wachsen nur: nach so vielen Aenderungen, wie der Index Profile hat, neu bauen
+    if (++s.aenderungen > s.index.size()) indizieren(s);
+    else s.index.aendern(i, eigen);
+  }
+
+  auto& partner = paarung_.partner;
+  warteschlange_.clear();
+  warteschlange_.push_back(i);
+  if (auto j = partner[i]; j != Paarung::kein)
+  {
+    warteschlange_.push_back(j);
+    ++zaehler_.pruefungen;
+    if (!p_.akzeptiert(i, j) || !p_.akzeptiert(j, i)) trennen(i);
+  }
+
+  // wer verlassen wird, sucht weiter; blockierende Paare koennen sich im
+  // Kreis abloesen, dann lohnt die ganze Vermittlung mehr
+  for (size_t schritte = 0; !warteschlange_.empty(); ++schritte)
+  {
+    if (schritte == p_.size())
+    {
+      paarung_ = vermitteln(p_, optionen_);
+      zaehler_.neu_bewertet += maenner_.nach_vermoegen.size() + maenner_.schwindler.size();
+      zaehler_.pruefungen += paarung_.antraege;
+      ++zaehler_.neu_vermittelt;
+      return;
+    }
+
+    auto a = warteschlange_.back();
+    warteschlange_.pop_back();
+    ++zaehler_.neu_bewertet;
+    auto z = blockierend(a, kandidaten_, beste_, zaehler_.pruefungen);
+    if (z == Paarung::kein) continue;
+
+    for (auto x : {a, z})
+    {
+      if (partner[x] == Paarung::kein) continue;
+      warteschlange_.push_back(partner[x]);
+      trennen(x);
+    }
+    partner[a] = z;
+    partner[z] = a;
+    ++paarung_.paare;
+  }
+}
+
+size_t Nachvermittlung::unzufriedene() const
+{
+  Kandidaten kandidaten, beste;
+  size_t pruefungen = 0, n = 0;
+  for (Index a = 0; a < p_.size(); ++a)
+    if (blockierend(a, kandidaten, beste, pruefungen) != Paarung::kein) ++n;
+  return n;
+}
@@ -0,0 +1,85 @@
+//: nachvermittlung.h : eine Paarung aktuell halten, waehrend sich Profile aendern
+
+#ifndef NACHVERMITTLUNG_H
+#define NACHVERMITTLUNG_H
+
+#include <set>
+#include <utility>
+#include <vector>
+#include "profilindex.h"
+#include "vermittlung.h"
+
+// Aendert ein Single sein Profil, wird nur neu bewertet, wen es betrifft:
+// das Paar wird getrennt, wenn einer den anderen nicht mehr akzeptiert; dann
+// suchen der Single und sein (bisheriger) Partner unter ihren Kandidaten
+// jemanden, der sie lieber haette als den eigenen Partner und den sie
+// lieber haetten (ein blockierendes Paar, wie Single::angebot es aufloest).
+// Wer dabei verlassen wird, sucht ebenso weiter.
+//
+// Kandidaten sind wie in vermitteln() die optionen.praeferenzen besten, die
+// ein Single akzeptiert, gesucht in einem ProfilIndex je Geschlecht, der mit
+// den Profilen mitgeht. Braucht eine Aenderung mehr Schritte, als die
+// Population Singles hat, wird statt dessen neu vermittelt.
+
+class Nachvermittlung
+{
+public:
+  using Index = Population::Index;
+
+  struct Zaehler
+  {
+    size_t aenderungen = 0;
+    size_t neu_bewertet = 0;   // Kandidatensuchen, vermitteln(): eine je Mann
+    size_t pruefungen = 0;     // Paare geprueft, vermitteln(): Paarung::antraege
+    size_t getrennt = 0;
+    size_t neu_vermittelt = 0;
+  };
+
+  explicit Nachvermittlung(Population p, Optionen const& optionen = {});
+  Nachvermittlung(Population p, Paarung paarung, Optionen const& optionen = {});
+
+  void aendern(Index i, Profil eigen, Profil wunsch);
+
+  Population const& population() const { return p_; }
+  Paarung const& paarung() const { return paarung_; }
+  Zaehler const& zaehler() const { return zaehler_; }
+
+  // Singles, die unter ihren Kandidaten jemanden finden, der sie lieber haette
+  // als den eigenen Partner und umgekehrt; zaehlt nicht mit, so teuer wie eine
+  // ganze Vermittlung
+  size_t unzufriedene() const;
+
+private:
+  // alle Singles eines Geschlechts als Kandidaten, aufgeteilt wie in vermitteln():
+  // Heiratsschwindler zeigen jedem ein anderes Profil und stehen nicht im Index
+  struct Seite
+  {
+    ProfilIndex index;
+    std::set<std::pair<double, Index>> nach_vermoegen;   // (-vermoegen, i) ohne Schwindler
+    std::vector<std::pair<double, Index>> schwindler;    // (groesse, i), sortiert
+    size_t aenderungen = 0;                              // seit dem Aufbau des Index
+  };
+
+  using Kandidaten = std::vector<std::pair<double, Index>>;
+
+  void aufbauen(char geschlecht);
+  void indizieren(Seite& s);
+  Seite& seite(char geschlecht) { return geschlecht == 'm' ? maenner_ : frauen_; }
+  Seite const& seite(char geschlecht) const { return geschlecht == 'm' ? maenner_ : frauen_; }
+
+  // die besten Kandidaten von a, aufsteigend nach (Bewertung, Index)
+  void kandidaten(Index a, Kandidaten& ergebnis, Kandidaten& beste) const;
+  // der beste Kandidat, mit dem a ein blockierendes Paar bildet, sonst kein
+  Index blockierend(Index a, Kandidaten& kandidaten, Kandidaten& beste, size_t& pruefungen) const;
+  void trennen(Index a);
+
+  Population p_;
+  Optionen optionen_;
+  Paarung paarung_;
+  Seite maenner_, frauen_;
+  std::vector<Index> warteschlange_;
+  Kandidaten kandidaten_, beste_;
+  Zaehler zaehler_;
+};
+
+#endif // NACHVERMITTLUNG_H
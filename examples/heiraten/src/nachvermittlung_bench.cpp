@@ -0,0 +1,99 @@
+//: nachvermittlung_bench.cpp : Profilaenderungen nachvermitteln statt neu vermitteln
+// g++ -std=c++17 -O2 -march=native -pthread nachvermittlung_bench.cpp nachvermittlung.cpp vermittlung.cpp namen.cpp profilindex.cpp abweichung.cpp single.cpp protokoll.cpp
+//
+// nachvermittlung_bench [singles=1000000] [aenderungen=10000]
+// Nach der ersten Vermittlung aendern zufaellige Singles ihr Profil: ein Jahr
+// aelter, das Vermoegen +-20%, jeder vierte auch seine Wuensche. Verglichen
+// werden Kandidatensuchen, Paarpruefungen und Zeit je Aenderung mit einer
+// ganzen neuen Vermittlung der geaenderten Population, dazu am Ende die Paare
+// und die unzufriedenen Singles beider Wege. Geprueft wird, dass die Paarung
+// gegenseitig und akzeptiert ist und der mitgefuehrte Index dasselbe findet
+// wie ein neu gebauter.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/random_data.hpp"
+#include "beispiel.h"
+#include "nachvermittlung.h"
+#include "vermittlung.h"
+
+// partner gegenseitig, paare richtig gezaehlt, jedes Paar akzeptiert sich
+bool gueltig(Population const& p, Paarung const& paarung)
+{
+  size_t paare = 0;
+  for (Population::Index i = 0; i < p.size(); ++i)
+  {
+    auto j = paarung.partner[i];
+    if (j == Paarung::kein) continue;
+    if (paarung.partner[j] != i || p.geschlecht(i) == p.geschlecht(j)) return false;
+    if (!p.akzeptiert(i, j) || !p.akzeptiert(j, i)) return false;
+    ++paare;
+  }
+  return paare == 2 * paarung.paare;
+}
+
+int main(int argc, char* argv[])
+{
+  auto n = bench::max_size(argc, argv, 1'000'000);
+  size_t anzahl = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000;
+
+  auto start = bench::Clock::now();
+  Nachvermittlung nv(zufaellig(n));
+  auto aufbau = bench::Seconds{bench::Clock::now() - start}.count();
+
+  bench::Xoshiro256 generator{n + 1};
+  auto gleich = [&](double a, double b) { return a + (b - a) * bench::unit(generator()); };
+  auto vorher = nv.zaehler();
+
+  start = bench::Clock::now();
+  for (size_t k = 0; k < anzahl; ++k)
+  {
+    auto i = Population::Index(bench::bounded(generator(), n));
+    auto const& p = nv.population();
+    auto eigen = p.eigen()[i];
+    auto wunsch = p.wunsch()[i];
+    ++eigen.alter;
+    eigen.vermoegen *= gleich(0.8, 1.2);
+    if (bench::bounded(generator(), 4) == 0)
+    {
+      wunsch.alter += int(bench::bounded(generator(), 5)) - 2;
+      wunsch.groesse = gleich(1.55, 1.95);
+    }
+    nv.aendern(i, eigen, wunsch);
+  }
+  auto nach = bench::Seconds{bench::Clock::now() - start}.count();
+  auto z = nv.zaehler();
+
+  start = bench::Clock::now();
+  auto ganz = vermitteln(nv.population());
+  auto neu = bench::Seconds{bench::Clock::now() - start}.count();
+  size_t maenner = 0;
+  for (Population::Index i = 0; i < n; ++i) maenner += nv.population().geschlecht(i) == 'm';
+
+  auto neu_bewertet = double(z.neu_bewertet - vorher.neu_bewertet) / anzahl;
+  auto pruefungen = double(z.pruefungen - vorher.pruefungen) / anzahl;
+  std::printf("%zu Singles, erste Vermittlung mit Aufbau %.3f s, %zu Aenderungen\n\n", n, aufbau, anzahl);
+  std::printf("%-28s %16s %16s %14s\n", "", "Kandidatensuchen", "Paarpruefungen", "Zeit [us]");
+  std::printf("%-28s %16.1f %16.1f %14.1f\n", "je Aenderung nachvermittelt", neu_bewertet, pruefungen, nach / anzahl * 1e6);
+  std::printf("%-28s %16zu %16zu %14.1f\n", "ganz neu vermittelt", maenner, ganz.antraege, neu * 1e6);
+  std::printf("%-28s %16.0f %16.0f %14.0f\n", "Faktor", maenner / neu_bewertet, ganz.antraege / pruefungen,
+              neu / (nach / anzahl));
+  std::printf("\n%zu Trennungen, %zu mal doch ganz neu vermittelt\n", z.getrennt, z.neu_vermittelt);
+
+  Nachvermittlung frisch(nv.population(), nv.paarung());
+  Nachvermittlung verglichen(nv.population(), ganz);
+  auto unzufrieden = nv.unzufriedene();
+  std::printf("\n%-28s %12s %14s\n", "", "Paare", "unzufrieden");
+  std::printf("%-28s %12zu %14zu\n", "nachvermittelt", nv.paarung().paare, unzufrieden);
+  std::printf("%-28s %12zu %14zu\n", "ganz neu vermittelt", ganz.paare, verglichen.unzufriedene());
+
+  auto ok = gueltig(nv.population(), nv.paarung()) && gueltig(nv.population(), ganz);
+  auto gleicher_index = frisch.unzufriedene() == unzufrieden;
+  std::printf("\n%s\n", ok ? "beide Paarungen gueltig" : "FEHLER: ungueltige Paarung");
+  std::printf("%s\n", gleicher_index ? "mitgefuehrter Index findet dasselbe wie ein neuer"
+                                     : "FEHLER: mitgefuehrter Index findet anderes als ein neuer");
+  return !(ok && gleicher_index);
+}
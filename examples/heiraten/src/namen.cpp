@@ -0,0 +1,46 @@
+//: namen.cpp : Namen aller Singles in einem gemeinsamen Speicherblock
+
+#include <functional>
+#include <utility>
+#include "namen.h"
+
+Namen::Nummer Namen::intern(std::string_view name)
+{
+  // hoechstens halb voll, so bleiben die Suchketten kurz
+  if (2 * (size() + 1) > tabelle_.size()) vergroessern();
+
+  auto maske = tabelle_.size() - 1;
+  for (auto i = std::hash<std::string_view>{}(name) & maske; ; i = (i + 1) & maske)
+  {
+    auto eintrag = tabelle_[i];
+    if (!eintrag)
+    {
+      auto n = Nummer(size());
+      zeichen_.insert(end(zeichen_), begin(name), end(name));
+      anfang_.push_back(zeichen_.size());
+      tabelle_[i] = n + 1;
+      return n;
+    }
+    if ((*this)[eintrag - 1] == name) return eintrag - 1;
+  }
+}
+
+void Namen::reserve(size_t namen, size_t zeichen)
+{
+  anfang_.reserve(namen + 1);
+  zeichen_.reserve(zeichen);
+  while (2 * namen > tabelle_.size()) vergroessern();
+}
+
+void Namen::vergroessern()
+{
+  std::vector<Nummer> tabelle(tabelle_.empty() ? 64 : 2 * tabelle_.size());
+  auto maske = tabelle.size() - 1;
+  for (Nummer n = 0; n < size(); ++n)
+  {
+    auto i = std::hash<std::string_view>{}((*this)[n]) & maske;
+    while (tabelle[i]) i = (i + 1) & maske;
+    tabelle[i] = n + 1;
+  }
+  tabelle_ = std::move(tabelle);
+}
@@ -0,0 +1,42 @@
+//: namen.h : Namen aller Singles in einem gemeinsamen Speicherblock
+
+#ifndef NAMEN_H
+#define NAMEN_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Statt eines std::string je Single stehen alle Namen hintereinander in
+// einem Block, jeder Name nur einmal (interniert): ein Single merkt sich
+// die Nummer. Name n ist zeichen()[anfang()[n] .. anfang()[n+1]), so kann
+// ein Abbild die Namen unveraendert uebernehmen.
+
+class Namen
+{
+public:
+  using Nummer = uint32_t;
+
+  // die Nummer von name, neu angelegt, wenn es ihn noch nicht gibt
+  Nummer intern(std::string_view name);
+
+  std::string_view operator[](Nummer n) const
+  {
+    return {zeichen_.data() + anfang_[n], size_t(anfang_[n + 1] - anfang_[n])};
+  }
+
+  auto size() const { return anfang_.size() - 1; }
+  void reserve(size_t namen, size_t zeichen);
+
+  auto const& anfang() const { return anfang_; }
+  auto const& zeichen() const { return zeichen_; }
+
+private:
+  void vergroessern();
+
+  std::vector<char> zeichen_;
+  std::vector<uint64_t> anfang_{0};
+  std::vector<Nummer> tabelle_;   // offene Adressierung: Nummer + 1, 0 ist frei
+};
+
+#endif // NAMEN_H
@@ -0,0 +1,180 @@
+//: profilindex.cpp : k-d-Baum ueber Profile fuer die Kandidatensuche
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "profilindex.h"
+
+namespace
+{
+
+double koordinate(Profil const& p, int achse)
+{
+  return achse == 0 ? p.alter : achse == 1 ? p.groesse : p.vermoegen;
+}
+
+// Rundungsreserve: die Untergrenze wird anders gerechnet als abweichung()
+constexpr double reserve = 1 - 1e-12;
+
+} // namespace
+
+ProfilIndex::ProfilIndex(std::vector<Profil> const& profile, std::vector<Index> const& indizes)
+: profile_{profile}
+, indizes_{indizes}
+{
+  if (indizes_.empty())
+  {
+    indizes_.resize(profile_.size());
+    std::iota(begin(indizes_), end(indizes_), 0);
+  }
+  if (profile_.empty()) return;
+
+  knoten_.reserve(2 * profile_.size() / blattgroesse + 1);
+  bauen(0, uint32_t(profile_.size()), 0);
+
+  for (auto const& p : profile_) spalten_.push_back(p);
+  profile_ = {};
+}
+
+uint32_t ProfilIndex::bauen(uint32_t anfang, uint32_t ende, unsigned tiefe)
+{
+  Quader q;
+  for (int a = 0; a < 3; ++a)
+  {
+    q.min[a] = HUGE_VAL;
+    q.max[a] = -HUGE_VAL;
+  }
+  for (auto i = anfang; i < ende; ++i)
+    for (int a = 0; a < 3; ++a)
+    {
+      q.min[a] = std::min(q.min[a], koordinate(profile_[i], a));
+      q.max[a] = std::max(q.max[a], koordinate(profile_[i], a));
+    }
+
+  auto k = uint32_t(knoten_.size());
+  knoten_.push_back({q, anfang, ende});
+  if (ende - anfang <= blattgroesse) return k;
+
+  // Teilung am Median, die Achsen reihum; Achsen ohne Ausdehnung (gleiches Alter) nicht
+  auto achse = int(tiefe % 3);
+  for (int i = 0; i < 2 && q.min[achse] == q.max[achse]; ++i) achse = (achse + 1) % 3;
+
+  auto mitte = anfang + (ende - anfang) / 2;
+  std::vector<uint32_t> ordnung(ende - anfang);
+  std::iota(begin(ordnung), end(ordnung), anfang);
+  std::nth_element(begin(ordnung), begin(ordnung) + (mitte - anfang), end(ordnung), [&](uint32_t a, uint32_t b)
+  {
+    return koordinate(profile_[a], achse) < koordinate(profile_[b], achse);
+  });
+
+  std::vector<Profil> profile;
+  std::vector<Index> indizes;
+  for (auto i : ordnung)
+  {
+    profile.push_back(profile_[i]);
+    indizes.push_back(indizes_[i]);
+  }
+  std::copy(begin(profile), end(profile), begin(profile_) + anfang);
+  std::copy(begin(indizes), end(indizes), begin(indizes_) + anfang);
+
+  auto links = bauen(anfang, mitte, tiefe + 1);
+  auto rechts = bauen(mitte, ende, tiefe + 1);
+  knoten_[k].links = links;
+  knoten_[k].rechts = rechts;
+  return k;
+}
+
+// kleinste abweichung(wunsch, p) fuer p im Quader
+double ProfilIndex::untergrenze(Profil const& wunsch, Quader const& q)
+{
+  auto abstand = [](double w, double min, double max)
+  {
+    if (!w) return 0.0;
+    auto d = std::max({min - w, w - max, 0.0});
+    return d / std::abs(w);
+  };
+
+  auto abw = abstand(wunsch.alter, q.min[0], q.max[0]) + abstand(wunsch.groesse, q.min[1], q.max[1]);
+  // das Vermoegen zaehlt nur, wenn es kleiner als gewuenscht ist
+  if (wunsch.vermoegen && q.max[2] < wunsch.vermoegen)
+    abw += (wunsch.vermoegen - q.max[2]) / std::abs(wunsch.vermoegen);
+  return abw * reserve;
+}
+
+void ProfilIndex::aendern(Index index, Profil profil)
+{
+  if (position_.empty())
+  {
+    position_.resize(*std::max_element(begin(indizes_), end(indizes_)) + size_t(1));
+    for (uint32_t i = 0; i < indizes_.size(); ++i) position_[indizes_[i]] = i;
+  }
+
+  auto pos = position_[index];
+  spalten_.setzen(pos, profil);
+  for (uint32_t k = 0; ; )
+  {
+    auto& q = knoten_[k].quader;
+    for (int a = 0; a < 3; ++a)
+    {
+      q.min[a] = std::min(q.min[a], koordinate(profil, a));
+      q.max[a] = std::max(q.max[a], koordinate(profil, a));
+    }
+    if (!knoten_[k].links) break;
+    k = pos < knoten_[knoten_[k].links].ende ? knoten_[k].links : knoten_[k].rechts;
+  }
+}
+
+void ProfilIndex::beste(Profil wunsch, double toleranz, size_t k,
+                        std::vector<std::pair<double, Index>>& ergebnis) const
+{
+  // ergebnis ist ein Max-Heap der bisher besten k
+  ergebnis.clear();
+  if (knoten_.empty() || k == 0) return;
+
+  auto grenze = [&] { return ergebnis.size() < k ? toleranz : ergebnis.front().first; };
+
+  auto suchen = [&](auto& selbst, uint32_t n) -> void
+  {
+    auto const& kn = knoten_[n];
+    if (untergrenze(wunsch, kn.quader) > grenze()) return;
+
+    if (kn.links)
+    {
+      // den naeheren Teilbaum zuerst: er senkt die Grenze am schnellsten
+      auto l = untergrenze(wunsch, knoten_[kn.links].quader);
+      auto r = untergrenze(wunsch, knoten_[kn.rechts].quader);
+      if (r < l)
+      {
+        selbst(selbst, kn.rechts);
+        selbst(selbst, kn.links);
+      }
+      else
+      {
+        selbst(selbst, kn.links);
+        selbst(selbst, kn.rechts);
+      }
+      return;
+    }
+
+    double abw[blattgroesse];
+    abweichungen(wunsch, spalten_, kn.anfang, kn.ende, abw);
+    for (auto i = kn.anfang; i < kn.ende; ++i)
+    {
+      auto kandidat = std::pair{abw[i - kn.anfang], indizes_[i]};
+      if (!(kandidat.first < toleranz)) continue;
+      if (ergebnis.size() < k)
+      {
+        ergebnis.push_back(kandidat);
+        std::push_heap(begin(ergebnis), end(ergebnis));
+      }
+      else if (kandidat < ergebnis.front())
+      {
+        std::pop_heap(begin(ergebnis), end(ergebnis));
+        ergebnis.back() = kandidat;
+        std::push_heap(begin(ergebnis), end(ergebnis));
+      }
+    }
+  };
+  suchen(suchen, 0);
+  std::sort_heap(begin(ergebnis), end(ergebnis));
+}
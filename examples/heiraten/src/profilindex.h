@@ -0,0 +1,94 @@
+//: profilindex.h : k-d-Baum ueber Profile fuer die Kandidatensuche
+
+#ifndef PROFILINDEX_H
+#define PROFILINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "abweichung.h"
+#include "single.h"
+
+// Alle drei Summanden von abweichung(wunsch, real) sind nicht negativ, also
+// muss jeder einzelne unter der Toleranz bleiben: die akzeptablen Profile
+// liegen in einem Quader um das Wunschprofil. Der Baum speichert fuer jeden
+// Knoten den umschliessenden Quader der Profile darin; ist die kleinste
+// Abweichung zu diesem Quader schon zu gross, wird der Knoten uebersprungen.
+
+class ProfilIndex
+{
+public:
+  using Index = uint32_t;
+
+  ProfilIndex() = default;
+  explicit ProfilIndex(std::vector<Profil> const& profile, std::vector<Index> const& indizes = {});
+
+  auto size() const { return indizes_.size(); }
+
+  // f(index, abw) fuer alle Profile mit abweichung(wunsch, profil) < toleranz
+  template <typename F>
+  void akzeptable(Profil wunsch, double toleranz, F f) const;
+
+  // die k Profile mit der kleinsten Abweichung unter toleranz, aufsteigend
+  // nach (abw, index); ergebnis wird ueberschrieben
+  void beste(Profil wunsch, double toleranz, size_t k,
+             std::vector<std::pair<double, Index>>& ergebnis) const;
+
+  // das Profil von index aendern: die Quader auf dem Weg zu seinem Blatt
+  // wachsen mit, schrumpfen aber nie; nach vielen Aenderungen neu bauen
+  void aendern(Index index, Profil profil);
+
+private:
+  struct Quader
+  {
+    double min[3], max[3];
+  };
+
+  struct Knoten
+  {
+    Quader quader;
+    uint32_t anfang, ende;        // Profile [anfang, ende)
+    uint32_t links = 0, rechts = 0;   // 0: Blatt
+  };
+
+  static constexpr uint32_t blattgroesse = 16;
+
+  uint32_t bauen(uint32_t anfang, uint32_t ende, unsigned tiefe);
+  static double untergrenze(Profil const& wunsch, Quader const& q);
+
+  template <typename F>
+  void akzeptable(uint32_t k, Profil const& wunsch, double toleranz, F& f) const;
+
+  std::vector<Knoten> knoten_;
+  std::vector<Profil> profile_;   // in Baumreihenfolge, nur waehrend des Aufbaus
+  Profile spalten_;               // dieselben spaltenweise fuer abweichungen()
+  std::vector<Index> indizes_;    // urspruenglicher Index je Profil
+  std::vector<uint32_t> position_;   // umgekehrt, erst mit dem ersten aendern()
+};
+
+// ===[ Templates ]================================================
+
+template <typename F>
+void ProfilIndex::akzeptable(Profil wunsch, double toleranz, F f) const
+{
+  if (!knoten_.empty()) akzeptable(0, wunsch, toleranz, f);
+}
+
+template <typename F>
+void ProfilIndex::akzeptable(uint32_t k, Profil const& wunsch, double toleranz, F& f) const
+{
+  auto const& n = knoten_[k];
+  if (untergrenze(wunsch, n.quader) >= toleranz) return;
+
+  if (n.links)
+  {
+    akzeptable(n.links, wunsch, toleranz, f);
+    akzeptable(n.rechts, wunsch, toleranz, f);
+    return;
+  }
+  double abw[blattgroesse];
+  abweichungen(wunsch, spalten_, n.anfang, n.ende, abw);
+  for (auto i = n.anfang; i < n.ende; ++i)
+    if (abw[i - n.anfang] < toleranz) f(indizes_[i], abw[i - n.anfang]);
+}
+
+#endif // PROFILINDEX_H
@@ -0,0 +1,96 @@
+//: profilindex_bench.cpp : Kandidatensuche mit und ohne ProfilIndex
+// g++ -std=c++17 -O2 -march=native -pthread profilindex_bench.cpp profilindex.cpp abweichung.cpp vermittlung.cpp namen.cpp single.cpp protokoll.cpp
+//
+// profilindex_bench [max_size=1e6]
+// Fuer die Wunschprofile der Maenner werden die Frauen mit abweichung < 0.25
+// gesucht, einmal durch Pruefen aller Paare, einmal im k-d-Baum. Beide muessen
+// dieselben Kandidaten und dieselben 16 besten liefern. Gemessen wird je Anfrage,
+// hochgerechnet auf alle Maenner: alle Paare wachsen quadratisch, der Index fast linear.
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "beispiel.h"
+#include "profilindex.h"
+
+int main(int argc, char* argv[])
+{
+  constexpr double toleranz = 0.25;
+  constexpr size_t k = 16;
+  auto max_size = bench::max_size(argc, argv, 1'000'000);
+
+  std::printf("%9s %9s %11s | %13s %13s %13s | %11s %11s\n", "Singles", "Anfragen", "Kandidaten",
+              "alle Paare", "Index alle", "Index beste", "alle Paare", "Index beste");
+  std::printf("%9s %9s %11s | %13s %13s %13s | %11s %11s\n", "", "", "je Anfrage",
+              "[us/Anfrage]", "[us/Anfrage]", "[us/Anfrage]", "gesamt [s]", "gesamt [s]");
+
+  for (size_t n = 1000; n <= max_size; n *= 10)
+  {
+    auto p = zufaellig(n);
+    std::vector<Profil> frauen, wuensche;
+    std::vector<ProfilIndex::Index> indizes;
+    for (Population::Index i = 0; i < p.size(); ++i)
+    {
+      if (p.geschlecht(i) == 'w')
+      {
+        frauen.push_back(p.eigen()[i]);
+        indizes.push_back(i);
+      }
+      else wuensche.push_back(p.wunsch()[i]);
+    }
+    auto anfragen = std::min<size_t>(wuensche.size(), 1000);
+
+    auto start = bench::Clock::now();
+    auto index = ProfilIndex(frauen, indizes);
+    auto aufbau = bench::Seconds{bench::Clock::now() - start}.count();
+
+    // Referenz: alle Paare
+    std::vector<size_t> anzahl(anfragen);
+    std::vector<std::vector<std::pair<double, ProfilIndex::Index>>> referenz(anfragen);
+    std::vector<std::pair<double, ProfilIndex::Index>> beste;
+    start = bench::Clock::now();
+    for (size_t q = 0; q < anfragen; ++q)
+    {
+      beste.clear();
+      for (size_t f = 0; f < frauen.size(); ++f)
+      {
+        auto abw = abweichung(wuensche[q], frauen[f]);
+        if (abw < toleranz) beste.emplace_back(abw, indizes[f]);
+      }
+      anzahl[q] = beste.size();
+      auto m = std::min(k, beste.size());
+      std::partial_sort(begin(beste), begin(beste) + m, end(beste));
+      referenz[q].assign(begin(beste), begin(beste) + m);
+    }
+    auto alle_paare = bench::Seconds{bench::Clock::now() - start}.count() / anfragen;
+
+    // Index: alle akzeptablen
+    size_t kandidaten = 0;
+    start = bench::Clock::now();
+    for (size_t q = 0; q < anfragen; ++q)
+    {
+      size_t gefunden = 0;
+      index.akzeptable(wuensche[q], toleranz, [&](ProfilIndex::Index, double) { ++gefunden; });
+      if (gefunden != anzahl[q]) return std::printf("Fehler: Anfrage %zu findet %zu statt %zu\n", q, gefunden, anzahl[q]), 1;
+      kandidaten += gefunden;
+    }
+    auto index_alle = bench::Seconds{bench::Clock::now() - start}.count() / anfragen;
+
+    // Index: die k besten
+    start = bench::Clock::now();
+    for (size_t q = 0; q < anfragen; ++q)
+    {
+      index.beste(wuensche[q], toleranz, k, beste);
+      if (beste != referenz[q]) return std::printf("Fehler: Anfrage %zu liefert andere beste\n", q), 1;
+    }
+    auto index_beste = bench::Seconds{bench::Clock::now() - start}.count() / anfragen;
+
+    std::printf("%9zu %9zu %11.0f | %13.2f %13.2f %13.2f | %11.3g %11.3g\n", n, anfragen,
+                double(kandidaten) / anfragen, alle_paare * 1e6, index_alle * 1e6, index_beste * 1e6,
+                alle_paare * wuensche.size(), aufbau + index_beste * wuensche.size());
+    std::fflush(stdout);
+  }
+}
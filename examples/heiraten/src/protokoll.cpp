@@ -0,0 +1,363 @@
+//: protokoll.cpp : gepuffertes Ereignisprotokoll der Vermittlung
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "protokoll.h"
+
+namespace protokoll
+{
+
+namespace
+{
+
+// Binaere Spur: kennung, dann Datensaetze in der Byte-Reihenfolge der Maschine
+//   Ereignis a b       1 + 4 + 4 Bytes
+//   name nummer laenge 1 + 4 + 4 Bytes und laenge Zeichen, vor der ersten Verwendung
+constexpr char kennung[8] = {'h', 'e', 'i', 'r', 'a', 't', 'e', 'n'};
+constexpr uint8_t namenssatz = 0xff;
+
+struct Eintrag
+{
+  Ereignis ereignis;
+  Nummer a, b;
+};
+
+template <typename Namen>
+void text(Eintrag const& e, Namen const& namen, std::string& aus)
+{
+  auto zeile = [&](char const* anfang, char const* mitte, std::string_view b)
+  {
+    aus += anfang;
+    aus += namen[e.a];
+    aus += mitte;
+    aus += b;
+    aus += '\n';
+  };
+  switch (e.ereignis)
+  {
+  case Ereignis::angebot:  zeile("Angebot:  ", " ?? ", namen[e.b]); break;
+  case Ereignis::partner:  zeile("Partner:  ", " == ", namen[e.b]); break;
+  case Ereignis::trennung: zeile("Trennung: ", " <> ", namen[e.b]); break;
+  case Ereignis::ausgabe:  zeile("", " == ", e.b == niemand ? "-" : std::string_view(namen[e.b])); break;
+  }
+}
+
+template <typename T>
+void anhaengen(std::string& aus, T wert)
+{
+  aus.append(reinterpret_cast<char const*>(&wert), sizeof(wert));
+}
+
+} // namespace
+
+#if HEIRATEN_PROTOKOLL
+
+namespace
+{
+
+// begrenzte Warteschlange fuer viele Erzeuger und einen Verbraucher (Vyukov):
+// jeder Platz zaehlt mit, in welcher Runde er frei oder gefuellt ist
+class Ring
+{
+public:
+  static constexpr size_t groesse = 1 << 16;
+
+  Ring()
+  : plaetze_{new Platz[groesse]}
+  {
+    for (size_t i = 0; i < groesse; ++i) plaetze_[i].runde.store(i, std::memory_order_relaxed);
+  }
+
+  bool hinein(Eintrag const& e)
+  {
+    auto pos = schreiben_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      auto& platz = plaetze_[pos % groesse];
+      auto runde = platz.runde.load(std::memory_order_acquire);
+      if (runde == pos)
+      {
+        if (schreiben_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          platz.eintrag = e;
+          // seq_cst: der Schreiber setzt erst wartet_ und prueft dann diesen Platz
+          platz.runde.store(pos + 1, std::memory_order_seq_cst);
+          return true;
+        }
+      }
+      else if (runde < pos) return false;   // voll
+      else pos = schreiben_.load(std::memory_order_relaxed);
+    }
+  }
+
+  // nur vom Verbraucher
+  bool heraus(Eintrag& e)
+  {
+    auto& platz = plaetze_[lesen_ % groesse];
+    if (platz.runde.load(std::memory_order_acquire) != lesen_ + 1) return false;
+    e = platz.eintrag;
+    platz.runde.store(lesen_ + groesse, std::memory_order_release);
+    ++lesen_;
+    return true;
+  }
+
+  // nur vom Verbraucher: der naechste Eintrag ist fertig geschrieben
+  bool bereit() const { return plaetze_[lesen_ % groesse].runde.load(std::memory_order_seq_cst) == lesen_ + 1; }
+
+  size_t geschrieben() const { return schreiben_.load(std::memory_order_acquire); }
+  size_t gelesen() const { return lesen_; }
+
+private:
+  struct Platz
+  {
+    std::atomic<size_t> runde;
+    Eintrag eintrag;
+  };
+
+  std::unique_ptr<Platz[]> plaetze_;
+  alignas(64) std::atomic<size_t> schreiben_{0};
+  alignas(64) size_t lesen_ = 0;
+};
+
+class Schreiber
+{
+public:
+  Schreiber()
+  : faden_{[this] { laufen(); }}
+  {
+  }
+
+  ~Schreiber()
+  {
+    {
+      std::lock_guard<std::mutex> sperre{warten_mutex_};
+      stopp_.store(true, std::memory_order_release);
+    }
+    wecker_.notify_one();
+    faden_.join();
+  }
+
+  Nummer anmelden(std::string_view name)
+  {
+    std::lock_guard<std::mutex> sperre{mutex_};
+    angemeldet_.push_back(name);
+    return Nummer(angemeldet_.size() - 1);
+  }
+
+  // weckt den Schreib-Thread nur, wenn er den Ring leer gefunden hat und wartet
+  void melden(Eintrag const& e)
+  {
+    while (!ring_.hinein(e)) std::this_thread::yield();   // Puffer voll
+    if (wartet_.load(std::memory_order_seq_cst) && wartet_.exchange(false)) wecken();
+  }
+
+  void leeren()
+  {
+    wecken();
+    auto bis = ring_.geschrieben();
+    while (erledigt_.load(std::memory_order_acquire) < bis) std::this_thread::yield();
+  }
+
+  // der Schreib-Thread liest out_ erst beim naechsten Eintrag wieder,
+  // und der wird nach dieser Zuweisung gemeldet
+  void ziel(std::ostream& out, Format format)
+  {
+    leeren();
+    out_ = &out;
+    format_ = format;
+    bekannt_.assign(anzahl(), false);
+    kopf_ = false;
+  }
+
+private:
+  void wecken()
+  {
+    { std::lock_guard<std::mutex> sperre{warten_mutex_}; }
+    wecker_.notify_one();
+  }
+
+  // Erst wartet_ setzen, dann den Ring pruefen; melden() fuellt den Ring und prueft
+  // dann wartet_. Alles seq_cst, so sieht mindestens einer von beiden den anderen
+  void warten()
+  {
+    std::unique_lock<std::mutex> sperre{warten_mutex_};
+    wartet_.store(true, std::memory_order_seq_cst);
+    wecker_.wait(sperre, [this] { return ring_.bereit() || stopp_.load(std::memory_order_acquire); });
+    wartet_.store(false, std::memory_order_relaxed);
+  }
+
+  size_t anzahl()
+  {
+    std::lock_guard<std::mutex> sperre{mutex_};
+    return angemeldet_.size();
+  }
+
+  void laufen()
+  {
+    // hoechstens grenze Bytes je Schreibvorgang; eine Zeile mehr passt noch
+    // in den reservierten Puffer, so fordert der Schreib-Thread nichts mehr an
+    constexpr size_t grenze = 1 << 19;
+    std::string puffer;
+    puffer.reserve(2 * grenze);
+    Eintrag e;
+    unsigned leer = 0;
+    for (;;)
+    {
+      auto stopp = stopp_.load(std::memory_order_acquire);
+      size_t n = 0;
+      {
+        // anmelden() kann angemeldet_ vergroessern, nur nicht waehrend eines Stapels
+        std::lock_guard<std::mutex> sperre{mutex_};
+        while (puffer.size() < grenze && ring_.heraus(e))
+        {
+          schreiben(e, puffer);
+          ++n;
+        }
+      }
+      if (n)
+      {
+        out_->write(puffer.data(), std::streamsize(puffer.size()));
+        puffer.clear();
+        leer = 0;
+        continue;
+      }
+
+      // der Ring ist leer: alles Geschriebene gilt als erledigt
+      if (erledigt_.load(std::memory_order_relaxed) != ring_.gelesen())
+      {
+        out_->flush();
+        erledigt_.store(ring_.gelesen(), std::memory_order_release);
+      }
+      if (stopp) return;
+
+      // erst kurz nachgeben, solange noch Angebote nachkommen, dann schlafen
+      if (++leer < 64) std::this_thread::yield();
+      else warten();
+    }
+  }
+
+  void schreiben(Eintrag const& e, std::string& aus)
+  {
+    if (format_ == Format::text)
+    {
+      text(e, angemeldet_, aus);
+      return;
+    }
+
+    if (!kopf_)
+    {
+      aus.append(kennung, sizeof(kennung));
+      kopf_ = true;
+    }
+    for (auto nummer : {e.a, e.b})
+    {
+      if (nummer == niemand) continue;
+      if (nummer >= bekannt_.size()) bekannt_.resize(angemeldet_.size());
+      if (bekannt_[nummer]) continue;
+      bekannt_[nummer] = true;
+      anhaengen(aus, namenssatz);
+      anhaengen(aus, nummer);
+      anhaengen(aus, uint32_t(angemeldet_[nummer].size()));
+      aus += angemeldet_[nummer];
+    }
+    anhaengen(aus, uint8_t(e.ereignis));
+    anhaengen(aus, e.a);
+    anhaengen(aus, e.b);
+  }
+
+  Ring ring_;
+  std::atomic<size_t> erledigt_{0};   // so viele Eintraege sind geschrieben
+  std::atomic<bool> stopp_{false};
+
+  // der Schreib-Thread schlaeft bei leerem Ring
+  std::mutex warten_mutex_;
+  std::condition_variable wecker_;
+  std::atomic<bool> wartet_{false};
+
+  std::mutex mutex_;
+  std::vector<std::string_view> angemeldet_;
+
+  // nur der Schreib-Thread, oder ziel() bei leerem Puffer
+  std::ostream* out_ = &std::cout;
+  Format format_ = Format::text;
+  std::vector<bool> bekannt_;   // Namen, die in der binaeren Spur schon stehen
+  bool kopf_ = false;
+
+  std::thread faden_;   // zuletzt, laeuft erst mit allem anderen an
+};
+
+Schreiber& schreiber()
+{
+  static Schreiber s;
+  return s;
+}
+
+} // namespace
+
+Nummer anmelden(std::string_view name)
+{
+  return schreiber().anmelden(name);
+}
+
+void melden(Ereignis ereignis, Nummer a, Nummer b)
+{
+  schreiber().melden({ereignis, a, b});
+}
+
+void leeren()
+{
+  schreiber().leeren();
+}
+
+void ziel(std::ostream& out, Format format)
+{
+  schreiber().ziel(out, format);
+}
+
+#endif // HEIRATEN_PROTOKOLL
+
+void uebersetzen(std::istream& spur, std::ostream& out)
+{
+  auto lesen = [&](auto& wert)
+  {
+    if (!spur.read(reinterpret_cast<char*>(&wert), sizeof(wert)))
+      throw std::runtime_error("protokoll: Spur bricht ab");
+  };
+
+  char k[sizeof(kennung)];
+  if (!spur.read(k, sizeof(k))) return;   // leere Spur
+  if (std::memcmp(k, kennung, sizeof(k)) != 0) throw std::runtime_error("protokoll: keine Spur");
+
+  std::vector<std::string> namen;
+  std::string aus;
+  uint8_t art;
+  while (spur.read(reinterpret_cast<char*>(&art), 1))
+  {
+    Nummer a, b;
+    lesen(a);
+    lesen(b);
+    if (art == namenssatz)
+    {
+      if (a >= namen.size()) namen.resize(a + 1);
+      namen[a].resize(b);
+      if (!spur.read(namen[a].data(), b)) throw std::runtime_error("protokoll: Spur bricht ab");
+      continue;
+    }
+    text({Ereignis(art), a, b}, namen, aus);
+    if (aus.size() > (1 << 16))
+    {
+      out.write(aus.data(), std::streamsize(aus.size()));
+      aus.clear();
+    }
+  }
+  out.write(aus.data(), std::streamsize(aus.size()));
+}
+
+} // namespace protokoll
@@ -0,0 +1,60 @@
+//: protokoll.h : gepuffertes Ereignisprotokoll der Vermittlung
+
+#ifndef PROTOKOLL_H
+#define PROTOKOLL_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Angebote, neue Partner, Trennungen und die Bekanntgabe landen als kleine
+// Eintraege (Ereignis und zwei Namensnummern) in einem Ringpuffer ohne Sperren.
+// Ein Schreib-Thread macht daraus den Text von output.txt oder eine binaere
+// Spur; der Aufrufer wartet nie auf die Ausgabe, nur auf einen vollen Puffer.
+//
+// Mit -DHEIRATEN_PROTOKOLL=0 sind anmelden() und melden() leere inline-
+// Funktionen, die der Compiler entfernt; Single::ausgabe() schreibt dann
+// direkt nach std::cout.
+
+#ifndef HEIRATEN_PROTOKOLL
+#define HEIRATEN_PROTOKOLL 1
+#endif
+
+namespace protokoll
+{
+
+enum class Ereignis : uint8_t { angebot, partner, trennung, ausgabe };
+enum class Format { text, binaer };
+
+using Nummer = uint32_t;                  // Nummer eines angemeldeten Namens
+constexpr Nummer niemand = Nummer(-1);    // kein Partner bei der Bekanntgabe
+
+#if HEIRATEN_PROTOKOLL
+
+// die Nummer, unter der name in den Eintraegen steht; der Schreib-Thread
+// liest name spaeter dort, wo er steht (Single::intern)
+Nummer anmelden(std::string_view name);
+
+void melden(Ereignis ereignis, Nummer a, Nummer b = niemand);
+
+// alles bisher Gemeldete ist geschrieben und out geleert
+void leeren();
+
+// ab jetzt nach out (nach leeren()); out muss bis zum naechsten ziel() leben
+void ziel(std::ostream& out, Format format = Format::text);
+
+#else
+
+inline Nummer anmelden(std::string_view) { return 0; }
+inline void melden(Ereignis, Nummer, Nummer = niemand) {}
+inline void leeren() {}
+inline void ziel(std::ostream&, Format = Format::text) {}
+
+#endif
+
+// eine binaere Spur als Text, wie ihn Format::text geschrieben haette
+void uebersetzen(std::istream& spur, std::ostream& text);
+
+} // namespace protokoll
+
+#endif // PROTOKOLL_H
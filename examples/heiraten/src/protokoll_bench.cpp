@@ -0,0 +1,138 @@
+//: protokoll_bench.cpp : Ereignisprotokoll gegen direkte Ausgabe
+// g++ -std=c++17 -O2 -march=native -pthread protokoll_bench.cpp single.cpp protokoll.cpp sonder.cpp
+//
+// protokoll_bench [singles=1000000] [datei=/dev/null]
+// 1. das Beispiel aus output.txt als binaere Spur, zurueck uebersetzt in Text
+//    muss sie dem Textprotokoll gleichen
+// 2. Angebote unter Singles-Objekten, jeder Mann bekommt 8 Frauen angeboten:
+//    Zeit mit dem Protokoll im Hintergrund gegen dieselben Zeilen, direkt
+//    mit operator<< geschrieben wie frueher in Single. Mit
+//    -DHEIRATEN_PROTOKOLL=0 zeigt die erste Zeit die Kosten ohne Protokoll.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/random_data.hpp"
+#include "protokoll.h"
+#include "single.h"
+#include "sonder.h"
+
+void beispiel()
+{
+  Single anton("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+  Single berta("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+  Heiratsschwindler claus("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0));
+  AnspruchsvollerSingle doris("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000));
+  BescheidenerSingle ernst("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000));
+
+  std::vector<Single*> maenner{&anton, &claus, &ernst};
+  std::vector<Single*> frauen{&berta, &doris};
+
+  for (auto m : maenner)
+    for (auto f : frauen) m->angebot(f);
+  for (auto f : frauen)
+    for (auto m : maenner) f->angebot(m);
+  for (auto m : maenner) m->ausgabe();
+  for (auto f : frauen) f->ausgabe();
+}
+
+// zufaellige Singles als Objekte, jeder fuenfte ist etwas Besonderes
+std::vector<std::unique_ptr<Single>> singles(size_t n)
+{
+  bench::Xoshiro256 generator{n};
+  auto gleich = [&](double a, double b) { return a + (b - a) * bench::unit(generator()); };
+
+  std::vector<std::unique_ptr<Single>> result;
+  result.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    auto name = "Single" + std::to_string(i);
+    auto geschlecht = i % 2 ? 'w' : 'm';
+    auto eigen = Profil(int(gleich(18, 80)), gleich(1.55, 1.95), gleich(0, 200000));
+    auto wunsch = Profil(eigen.alter + int(gleich(-5, 5)), gleich(1.55, 1.95), gleich(0, 50000));
+    switch (bench::bounded(generator(), 20))
+    {
+    case 0:  result.push_back(std::make_unique<AnspruchsvollerSingle>(name, geschlecht, eigen, wunsch)); break;
+    case 1:  result.push_back(std::make_unique<BescheidenerSingle>(name, geschlecht, eigen, wunsch)); break;
+    case 2:  result.push_back(std::make_unique<Heiratsschwindler>(name, geschlecht, eigen, wunsch)); break;
+    default: result.push_back(std::make_unique<Single>(name, geschlecht, eigen, wunsch)); break;
+    }
+  }
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+#if HEIRATEN_PROTOKOLL
+  {
+    std::ostringstream text, spur, zurueck;
+    protokoll::ziel(text);
+    beispiel();
+    protokoll::ziel(spur, protokoll::Format::binaer);
+    beispiel();
+    protokoll::ziel(std::cout);
+
+    std::istringstream lesen(spur.str());
+    protokoll::uebersetzen(lesen, zurueck);
+    auto gleich = text.str() == zurueck.str();
+    std::cout << "Beispiel: " << text.str().size() << " Bytes Text, " << spur.str().size()
+              << " Bytes Spur, " << (gleich ? "gleicher Text\n\n" : "VERSCHIEDENER Text\n\n");
+    if (!gleich) return 1;
+  }
+#endif
+
+  auto n = bench::max_size(argc, argv, 1'000'000);
+  auto datei = argc > 2 ? argv[2] : "/dev/null";
+  std::ofstream out(datei);
+
+  auto alle = singles(n);
+  std::vector<Single*> maenner, frauen;
+  for (auto& s : alle) (s->geschlecht() == 'm' ? maenner : frauen).push_back(s.get());
+
+  // dieselben Angebote fuer beide Laeufe
+  constexpr size_t je_mann = 8;
+  bench::Xoshiro256 generator{1};
+  std::vector<uint32_t> angebote(maenner.size() * je_mann);
+  for (auto& f : angebote) f = uint32_t(bench::bounded(generator(), frauen.size()));
+
+  auto laufen = [&](protokoll::Format format)
+  {
+    protokoll::ziel(out, format);
+    auto start = bench::Clock::now();
+    for (size_t m = 0; m < maenner.size(); ++m)
+      for (size_t k = 0; k < je_mann; ++k) maenner[m]->angebot(frauen[angebote[m * je_mann + k]]);
+    auto gemeldet = bench::Clock::now();
+    protokoll::leeren();
+    auto geschrieben = bench::Clock::now();
+    protokoll::ziel(std::cout);
+    return std::pair{bench::Seconds{gemeldet - start}.count(), bench::Seconds{geschrieben - start}.count()};
+  };
+  auto text = laufen(protokoll::Format::text);
+  auto spur = laufen(protokoll::Format::binaer);
+
+  // die Zeilen "Angebot:  a ?? b", wie Single::angebot sie frueher schrieb
+  auto direkt_start = bench::Clock::now();
+  for (size_t m = 0; m < maenner.size(); ++m)
+    for (size_t k = 0; k < je_mann; ++k)
+      out << "Angebot:  " << maenner[m]->name() << " ?? " << frauen[angebote[m * je_mann + k]]->name() << '\n';
+  out.flush();
+  auto direkt = bench::Seconds{bench::Clock::now() - direkt_start}.count();
+
+  auto zeile = [&](char const* was, double sekunden)
+  {
+    std::printf("%-36s %8.3f s %8.1f ns/Angebot\n", was, sekunden, 1e9 * sekunden / angebote.size());
+  };
+  std::printf("%zu Singles, %zu Angebote nach %s\n", n, angebote.size(), datei);
+  zeile("Protokoll als Text, gemeldet", text.first);
+  zeile("Protokoll als Text, geschrieben", text.second);
+  zeile("Protokoll als Spur, gemeldet", spur.first);
+  zeile("Protokoll als Spur, geschrieben", spur.second);
+  zeile("nur die Angebotszeilen, direkt <<", direkt);
+}
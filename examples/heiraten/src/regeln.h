@@ -0,0 +1,127 @@
+//: regeln.h : Singles mit Regeln als Template-Parameter statt virtueller Funktionen
+
+#ifndef REGELN_H
+#define REGELN_H
+
+#include "single.h"
+
+// Dieselben Stellschrauben wie in Single und sonder.h, aber zur Compilezeit:
+//   Annahme  - akzeptiert(ich, s):          kommt s ueberhaupt in Frage ?
+//   Wertung  - besser(ich, neu, bisher):    ist neu besser als der bisherige Partner ?
+//   Auftritt - auftreten(eigen, s):         wie man sich s praesentiert
+// Eine neue Art von Single ist eine neue Kombination, ohne vtable: angebot()
+// kennt den Typ beider Seiten und der Compiler kann alles einsetzen.
+
+namespace regel
+{
+
+// ===[ Annahme ]==================================================
+
+template <int prozent>
+struct Toleranz
+{
+  static bool akzeptiert(Person const& ich, Person const& s)
+  {
+    return abweichung(ich.wunschprofil(), s.eigenprofil()) < prozent / 100.0;
+  }
+};
+
+struct Jeder
+{
+  static bool akzeptiert(Person const&, Person const&) { return true; } // schaut nicht einmal hin
+};
+
+struct Reich
+{
+  static bool akzeptiert(Person const&, Person const& s) { return s.eigenprofil().vermoegen > 50000; }
+};
+
+// ===[ Wertung ]==================================================
+
+struct Naehe
+{
+  static bool besser(Person const& ich, Person const& neu, Person const& bisher)
+  {
+    return abweichung(ich.wunschprofil(), neu.eigenprofil()) <
+           abweichung(ich.wunschprofil(), bisher.eigenprofil()); // naeher am Ideal
+  }
+};
+
+struct Vermoegen
+{
+  static bool besser(Person const&, Person const& neu, Person const& bisher)
+  {
+    return neu.eigenprofil().vermoegen > bisher.eigenprofil().vermoegen;
+  }
+};
+
+// ===[ Auftritt ]=================================================
+
+struct Ehrlich
+{
+  static void auftreten(Profil&, Person const&) {}
+};
+
+// Alter und Vermoegen nach den Wuenschen von s, die Groesse bleibt
+struct Wunschbild
+{
+  static void auftreten(Profil& eigen, Person const& s)
+  {
+    eigen.alter = s.wunschprofil().alter;
+    eigen.vermoegen = s.wunschprofil().vermoegen;
+  }
+};
+
+} // namespace regel
+
+// ===[ Single mit festen Regeln ]=================================
+
+// Partner werden als Person gemerkt, angebot() und antrag() nehmen jede
+// SingleMit<...>; mit dem virtuellen Single mischen laesst er sich nicht.
+
+template <typename Annahme, typename Wertung = regel::Naehe, typename Auftritt = regel::Ehrlich>
+class SingleMit : public Person
+{
+public:
+  using Person::Person;
+
+  // Vermittlung
+  template <typename Anderer>
+  bool angebot(Anderer* s)
+  {
+    Auftritt::auftreten(eigenprofil_, *s);
+    melden(protokoll::Ereignis::angebot, s);
+    if (!verbesserung(*s)) return false;
+    if (!s->antrag(this)) return false;
+    neuerPartner(s);
+    melden(protokoll::Ereignis::partner, s);
+    return true;
+  }
+
+  template <typename Anderer>
+  bool antrag(Anderer* s)
+  {
+    if (!verbesserung(*s)) return false;
+    neuerPartner(s);
+    return true;
+  }
+
+private:
+  bool verbesserung(Person const& s) const
+  {
+    if (!Annahme::akzeptiert(*this, s)) return false;
+    if (!partner_) return true;
+    return Wertung::besser(*this, s, *partner_);
+  }
+};
+
+// die vier Arten aus single.h und sonder.h
+namespace statisch
+{
+using Single = SingleMit<regel::Toleranz<25>>;
+using AnspruchsvollerSingle = SingleMit<regel::Toleranz<10>>;
+using BescheidenerSingle = SingleMit<regel::Jeder>;
+using Heiratsschwindler = SingleMit<regel::Reich, regel::Vermoegen, regel::Wunschbild>;
+} // namespace statisch
+
+#endif // REGELN_H
@@ -0,0 +1,212 @@
+//: regeln_bench.cpp : virtuelle Regeln (Single) gegen Template-Regeln (SingleMit)
+// g++ -std=c++17 -O2 -march=native -pthread -DHEIRATEN_PROTOKOLL=0 regeln_bench.cpp single.cpp protokoll.cpp sonder.cpp
+//
+// regeln_bench [kandidatinnen=1000000]
+// 1. die fuenf Singles aus output.txt als statische Typen: dieselben Paare
+// 2. je zwei Maenner jeder Art bekommen alle Kandidatinnen angeboten, gleich
+//    viele jeder Art. Beide Welten liegen nach Art in zusammenhaengenden
+//    Vektoren und werden in derselben Reihenfolge vermittelt; virtuell geht
+//    jeder Aufruf ueber Single*, statisch kennt der Compiler beide Typen.
+//    Die Paare muessen gleich sein. Zum Vergleich virtuell in gemischter
+//    Reihenfolge, wie eine Vermittlung sie sieht: dann kommen Sprungvorhersage
+//    und Cache-Fehlzugriffe dazu (andere Paare).
+// Ohne Protokoll, damit nur die Regeln zaehlen.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../benchmarking/random_data.hpp"
+#include "regeln.h"
+#include "single.h"
+#include "sonder.h"
+
+// f fuer jedes Element eines Tupels, der Reihe nach
+template <typename Tupel, typename F>
+void jede(Tupel& t, F f)
+{
+  std::apply([&](auto&... x) { (f(x), ...); }, t);
+}
+
+struct Eintrag
+{
+  std::string name;
+  char geschlecht;
+  Profil eigen, wunsch;
+};
+
+std::string_view partner(Person const& s)
+{
+  return s.partner() ? s.partner()->name() : "-";
+}
+
+using Daten = std::array<std::vector<Eintrag>, 4>;   // je Art: gewoehnlich, anspruchsvoll, bescheiden, schwindler
+
+template <typename... Arten>
+struct Welt
+{
+  using Gruppen = std::tuple<std::vector<Arten>...>;
+
+  Welt(Daten const& m, Daten const& f)
+  {
+    aufbauen(maenner, m);
+    aufbauen(frauen, f);
+  }
+
+  static void aufbauen(Gruppen& gruppen, Daten const& daten)
+  {
+    size_t art = 0;
+    jede(gruppen, [&](auto& v)
+    {
+      v.reserve(daten[art].size());   // Partner sind Zeiger, die Vektoren wachsen nicht mehr
+      for (auto const& e : daten[art]) v.emplace_back(e.name, e.geschlecht, e.eigen, e.wunsch);
+      ++art;
+    });
+  }
+
+  template <typename F>
+  static void alle(Gruppen& gruppen, F f)
+  {
+    jede(gruppen, [&](auto& v) { for (auto& s : v) f(s); });
+  }
+
+  void loesen()
+  {
+    auto loesen = [](Person& s) { if (s.partner()) s.trennung(); };
+    alle(maenner, loesen);
+    alle(frauen, loesen);
+  }
+
+  std::vector<std::string_view> partner()
+  {
+    std::vector<std::string_view> namen;
+    auto name = [&](Person& s) { namen.push_back(::partner(s)); };
+    alle(maenner, name);
+    alle(frauen, name);
+    return namen;
+  }
+
+  Gruppen maenner, frauen;
+};
+
+using Virtuell = Welt<Single, AnspruchsvollerSingle, BescheidenerSingle, Heiratsschwindler>;
+using Statisch = Welt<statisch::Single, statisch::AnspruchsvollerSingle, statisch::BescheidenerSingle, statisch::Heiratsschwindler>;
+
+bool beispiel()
+{
+  std::vector<std::string_view> virtuell, statisch;
+  {
+    Single anton("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+    Single berta("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+    Heiratsschwindler claus("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0));
+    AnspruchsvollerSingle doris("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000));
+    BescheidenerSingle ernst("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000));
+
+    std::vector<Single*> maenner{&anton, &claus, &ernst}, frauen{&berta, &doris};
+    for (auto m : maenner)
+      for (auto f : frauen) m->angebot(f);
+    for (auto f : frauen)
+      for (auto m : maenner) f->angebot(m);
+    for (auto s : std::initializer_list<Person const*>{&anton, &claus, &ernst, &berta, &doris}) virtuell.push_back(partner(*s));
+  }
+  {
+    statisch::Single anton("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+    statisch::Single berta("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+    statisch::Heiratsschwindler claus("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0));
+    statisch::AnspruchsvollerSingle doris("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000));
+    statisch::BescheidenerSingle ernst("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000));
+
+    auto maenner = std::tie(anton, claus, ernst);
+    auto frauen = std::tie(berta, doris);
+    jede(maenner, [&](auto& m) { jede(frauen, [&](auto& f) { m.angebot(&f); }); });
+    jede(frauen, [&](auto& f) { jede(maenner, [&](auto& m) { f.angebot(&m); }); });
+
+    // nur Abweichungen, gleiche Paare zeigt die Zeile "Beispiel:" an
+    for (auto s : std::initializer_list<Person const*>{&anton, &claus, &ernst, &berta, &doris})
+    {
+      statisch.push_back(partner(*s));
+      auto const& erwartet = virtuell[statisch.size() - 1];
+      if (statisch.back() != erwartet)
+        std::printf("%.*s: statisch %.*s, virtuell %.*s\n", int(s->name().size()), s->name().data(),
+                    int(statisch.back().size()), statisch.back().data(), int(erwartet.size()), erwartet.data());
+    }
+  }
+  return virtuell == statisch;
+}
+
+int main(int argc, char* argv[])
+{
+  auto n = bench::max_size(argc, argv, 1'000'000);
+  constexpr size_t je_art = 2;
+
+  auto gleiches_beispiel = beispiel();
+  std::printf("Beispiel: %s\n\n", gleiches_beispiel ? "dieselben Paare wie mit Single" : "FEHLER: andere Paare als mit Single");
+
+  bench::Xoshiro256 generator{n};
+  auto gleich = [&](double a, double b) { return a + (b - a) * bench::unit(generator()); };
+  auto eintrag = [&](std::string name, char geschlecht)
+  {
+    auto eigen = Profil(int(gleich(18, 80)), gleich(1.55, 1.95), gleich(0, 200000));
+    auto wunsch = Profil(eigen.alter + int(gleich(-5, 5)), gleich(1.55, 1.95), gleich(0, 50000));
+    return Eintrag{std::move(name), geschlecht, eigen, wunsch};
+  };
+
+  Daten maenner, frauen;
+  for (size_t art = 0; art < maenner.size(); ++art)
+    for (size_t i = 0; i < je_art; ++i) maenner[art].push_back(eintrag("Mann " + std::to_string(art * je_art + i), 'm'));
+  for (size_t i = 0; i < n; ++i) frauen[bench::bounded(generator(), frauen.size())].push_back(eintrag("Frau " + std::to_string(i), 'w'));
+
+  Virtuell virtuell(maenner, frauen);
+  Statisch statisch(maenner, frauen);
+
+  std::vector<Single*> zeiger_maenner, zeiger_frauen;
+  Virtuell::alle(virtuell.maenner, [&](Single& s) { zeiger_maenner.push_back(&s); });
+  Virtuell::alle(virtuell.frauen, [&](Single& s) { zeiger_frauen.push_back(&s); });
+  auto gemischt = zeiger_frauen;
+  std::shuffle(gemischt.begin(), gemischt.end(), generator);
+
+  auto ueber_zeiger = [&](std::vector<Single*> const& kandidatinnen)
+  {
+    return [&, liste = &kandidatinnen]
+    {
+      for (auto m : zeiger_maenner)
+        for (auto f : *liste) m->angebot(f);
+    };
+  };
+  auto mit_typen = [&]
+  {
+    jede(statisch.maenner, [&](auto& ms)
+    {
+      for (auto& m : ms)
+        jede(statisch.frauen, [&](auto& fs) { for (auto& f : fs) m.angebot(&f); });
+    });
+  };
+
+  // die schnellste von 5 Vermittlungen, jede von vorn
+  auto messen = [](auto& welt, auto vermitteln) { return bench::best_of(5, [&] { welt.loesen(); }, vermitteln); };
+
+  auto angebote = double(zeiger_maenner.size() * zeiger_frauen.size());
+  auto virtuell_zeit = messen(virtuell, ueber_zeiger(zeiger_frauen));
+  auto statisch_zeit = messen(statisch, mit_typen);
+  auto gleiche_paare = virtuell.partner() == statisch.partner();
+  auto gemischt_zeit = messen(virtuell, ueber_zeiger(gemischt));
+
+  std::printf("%zu Kandidatinnen, %zu Maenner, %.0f Angebote\n\n", zeiger_frauen.size(), zeiger_maenner.size(), angebote);
+  std::printf("%-32s %12s %14s %10s\n", "", "Zeit [s]", "ns/Angebot", "Faktor");
+  auto zeile = [&](char const* was, double sekunden)
+  {
+    std::printf("%-32s %12.3f %14.2f %10.2f\n", was, sekunden, sekunden / angebote * 1e9, sekunden / statisch_zeit);
+  };
+  zeile("statisch (SingleMit)", statisch_zeit);
+  zeile("virtuell (Single*)", virtuell_zeit);
+  zeile("virtuell, gemischte Reihenfolge", gemischt_zeit);
+  std::printf("\n%s\n", gleiche_paare ? "statisch und virtuell: dieselben Paare" : "FEHLER: statisch andere Paare als virtuell");
+
+  return !(gleiches_beispiel && gleiche_paare);
+}
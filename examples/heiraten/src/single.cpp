@@ -1,39 +1,54 @@
 //: single.cpp : nach [Ulrich Kaiser: C/C++, S.928ff]
 
 #include <iostream>
+#include <string>
+#include <unordered_set>
 #include "single.h"
 
-// Hilfsfunktionen
+// ===[ Implementation Person ]=========================================
 
-double abweichung(double a, double b)
+std::string_view Person::intern(std::string_view name)
 {
-  if (!a) return 0;
-  double abw = (a-b)/a;
-  return abw < 0 ? -abw : abw;
+  // die Knoten eines unordered_set wandern nie, also auch ihre Zeichen nicht
+  static std::unordered_set<std::string> tabelle;
+  return *tabelle.insert(std::string(name)).first;
 }
 
-double abweichung(Profil wunsch, Profil real)
+Person::Person(std::string_view name, char geschlecht, Profil eigen, Profil wunsch)
+: name_{intern(name)}
+, geschlecht_{geschlecht}
+, nummer_{protokoll::anmelden(name_)}
+, eigenprofil_{eigen}
+, wunschprofil_{wunsch}
 {
-  double abw = abweichung(wunsch.alter, real.alter) +
-               abweichung(wunsch.groesse, real.groesse);
-
-  if (wunsch.vermoegen > real.vermoegen)
-  {
-    abw += abweichung(wunsch.vermoegen, real.vermoegen);
-  }
-  return abw;
 }
 
-// ===[ Implementation Single ]=========================================
+void Person::neuerPartner(Person* s)
+{
+  if (partner_) partner_->trennung();
+  partner_ = s;
+}
 
-Single::Single(std::string name, char geschlecht, Profil eigen, Profil wunsch)
-: name_{name}
-, geschlecht_{geschlecht}
-, eigenprofil_{eigen}
-, wunschprofil_{wunsch}
+void Person::trennung() // nimmt zur Kenntnis, dass Partner ihn verlaesst
 {
+  melden(protokoll::Ereignis::trennung, partner_);
+  partner_ = nullptr; // seufz
+}
+
+// Bekanntgabe
+
+void Person::ausgabe()
+{
+#if HEIRATEN_PROTOKOLL
+  protokoll::melden(protokoll::Ereignis::ausgabe, nummer_, partner_ ? partner_->nummer_ : protokoll::niemand);
+#else
+  std::cout << name() << " == " 
+	<< (partner_ ? partner_->name() : "-") << '\n';
+#endif
 }
 
+// ===[ Implementation Single ]=========================================
+
 // Vermittlung
 
 bool Single::akzeptiert(Single* s)  // kommt s ueberhaupt in Frage ?
@@ -52,18 +67,6 @@ bool Single::verbesserung(Single* s) // Verbesserung durch s als Partner ?
   return neu < alt ? true : false; // neuer Partner naeher am Ideal
 }
 
-void Single::neuerPartner(Single* s)
-{
-  if (partner_) partner_->trennung();
-  partner_ = s;
-}
-
-void Single::trennung() // nimmt zur Kenntnis, dass Partner ihn verlaesst
-{
-  std::cout << "Trennung: " << name() << " <> " << partner_->name() << '\n';
-  partner_ = nullptr; // seufz
-}
-
 bool Single::antrag(Single* s)  // die Gretchenfrage wird beantwortet
 {
   if (!verbesserung(s)) return false;
@@ -73,18 +76,10 @@ bool Single::antrag(Single* s)  // die Gretchenfrage wird beantwortet
 
 bool Single::angebot(Single* s) // von der Partnervermittlung vorgeschlagen
 {
-  std::cout << "Angebot:  " << name() << " ?? " << s->name() << '\n';
+  melden(protokoll::Ereignis::angebot, s);
   if (!verbesserung(s)) return false;
   if (!s->antrag(this)) return false;
   neuerPartner(s);
-  std::cout << "Partner:  " << name() << " == " << s->name() << '\n';
+  melden(protokoll::Ereignis::partner, s);
   return true;
 }
-
-// Bekanntgabe
-
-void Single::ausgabe()
-{
-  std::cout << name() << " == " 
-	<< (partner_ ? partner_->name() : "-") << '\n';
-}
@@ -3,7 +3,8 @@
 #ifndef SINGLE_H
 #define SINGLE_H
 
-#include <string>
+#include <string_view>
+#include "protokoll.h"
 
 // Hilfsdaten
 
@@ -18,43 +19,86 @@ struct Profil
   double vermoegen;
 };
 
-// Hilfsfunktionen
+// Hilfsfunktionen, inline: sie liegen auf dem heissen Pfad jeder Vermittlung
 
-double abweichung(Profil wunsch, Profil real);
+inline double abweichung(double a, double b)
+{
+  if (!a) return 0;
+  double abw = (a-b)/a;
+  return abw < 0 ? -abw : abw;
+}
 
-// ===[ alleinstehende Personen ]==========================
+inline double abweichung(Profil wunsch, Profil real)
+{
+  double abw = abweichung(wunsch.alter, real.alter) +
+               abweichung(wunsch.groesse, real.groesse);
 
-class Single
+  if (wunsch.vermoegen > real.vermoegen)
+  {
+    abw += abweichung(wunsch.vermoegen, real.vermoegen);
+  }
+  return abw;
+}
+
+// ===[ Person: Daten und Partnerschaft ]==================
+
+// Alles an einem Single ausser den Regeln der Vermittlung. Die Regeln
+// kommen als virtuelle Funktionen (Single) oder als Template-Parameter
+// (SingleMit in regeln.h) dazu; Partner koennen beides sein.
+
+class Person
 {
 public:
-  virtual ~Single() { if (partner_) partner_->partner_ = nullptr; }	
-  
-  Single(std::string name, char geschlecht, Profil eigen, Profil wunsch);
+  Person(std::string_view name, char geschlecht, Profil eigen, Profil wunsch);
 
-  auto name()         const { return name_; }
-  auto geschlecht()   const { return geschlecht_; }
-  auto eigenprofil()  const { return eigenprofil_; }
-  auto wunschprofil() const { return wunschprofil_; }
+  std::string_view name()      const { return name_; }
+  char geschlecht()            const { return geschlecht_; }
+  Profil const& eigenprofil()  const { return eigenprofil_; }
+  Profil const& wunschprofil() const { return wunschprofil_; }
+  Person const* partner()      const { return partner_; }
+
+  // jeder Name nur einmal gespeichert; die Views bleiben bis zum Programmende gueltig
+  static std::string_view intern(std::string_view name);
 
-  // Vermittlung
-  virtual bool angebot(Single* s);
-  bool antrag(Single* s);
   void trennung();
 
   // Bekanntgabe
   void ausgabe();
 
 protected:
-  void neuerPartner(Single* s);
-  virtual bool verbesserung(Single* s);
-  virtual bool akzeptiert(Single* s);
+  ~Person() { if (partner_) partner_->partner_ = nullptr; }
+
+  void neuerPartner(Person* s);
+  void melden(protokoll::Ereignis ereignis, Person const* s) const
+  {
+    protokoll::melden(ereignis, nummer_, s->nummer_);
+  }
 
 private:
-  std::string name_;
+  std::string_view name_;      // in der Namenstabelle von intern()
   char geschlecht_;
-protected:  
+  protokoll::Nummer nummer_;   // name_ im Ereignisprotokoll
+protected:
   Profil eigenprofil_, wunschprofil_;
-  Single *partner_{nullptr};
+  Person *partner_{nullptr};
+};
+
+// ===[ alleinstehende Personen ]==========================
+
+class Single : public Person
+{
+public:
+  virtual ~Single() = default;
+
+  using Person::Person;
+
+  // Vermittlung
+  virtual bool angebot(Single* s);
+  bool antrag(Single* s);
+
+protected:
+  virtual bool verbesserung(Single* s);
+  virtual bool akzeptiert(Single* s);
 };
 
 #endif // __SINGLE_H__
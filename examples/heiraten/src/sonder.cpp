@@ -0,0 +1,40 @@
+//: sonder.cpp : Spezialfaelle von Singles
+
+#include "sonder.h"
+
+// ===[ Implementation AnspruchsvollerSingle ]=====================
+
+bool AnspruchsvollerSingle::akzeptiert(Single* s)
+{
+  return abweichung(wunschprofil(), s->eigenprofil()) < 0.10;
+}
+
+// ===[ Implementation BescheidenerSingle ]========================
+
+bool BescheidenerSingle::akzeptiert(Single*)
+{
+  return true; // schaut nicht einmal hin
+}
+
+// ===[ Implementation Heiratsschwindler ]=========================
+
+bool Heiratsschwindler::akzeptiert(Single* s)
+{
+  return s->eigenprofil().vermoegen > 50000;
+}
+
+bool Heiratsschwindler::verbesserung(Single* s)
+{
+  if (!akzeptiert(s)) return false;
+  if (!partner_) return true;
+
+  return s->eigenprofil().vermoegen > partner_->eigenprofil().vermoegen;
+}
+
+bool Heiratsschwindler::angebot(Single* s)
+{
+  // Alter und Vermoegen nach den Wuenschen von s, die Groesse bleibt
+  eigenprofil_.alter = s->wunschprofil().alter;
+  eigenprofil_.vermoegen = s->wunschprofil().vermoegen;
+  return Single::angebot(s);
+}
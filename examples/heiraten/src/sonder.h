@@ -0,0 +1,44 @@
+//: sonder.h : Spezialfaelle von Singles
+
+#ifndef SONDER_H
+#define SONDER_H
+
+#include "single.h"
+
+// ===[ anspruchsvoller Single: nur 10 Prozent Toleranz ]==========
+
+class AnspruchsvollerSingle : public Single
+{
+public:
+  using Single::Single;
+
+protected:
+  bool akzeptiert(Single* s) override;
+};
+
+// ===[ bescheidener Single: akzeptiert jeden ]====================
+
+class BescheidenerSingle : public Single
+{
+public:
+  using Single::Single;
+
+protected:
+  bool akzeptiert(Single* s) override;
+};
+
+// ===[ Heiratsschwindler: achtet nur aufs Geld ]==================
+
+class Heiratsschwindler : public Single
+{
+public:
+  using Single::Single;
+
+  bool angebot(Single* s) override;
+
+protected:
+  bool verbesserung(Single* s) override;
+  bool akzeptiert(Single* s) override;
+};
+
+#endif // SONDER_H
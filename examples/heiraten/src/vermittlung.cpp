@@ -0,0 +1,369 @@
+//: vermittlung.cpp : Partnervermittlung fuer Millionen von Singles
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include "../../concurrency/thread_pool.hpp"
+#include "profilindex.h"
+#include "vermittlung.h"
+
+// ===[ Population ]===============================================
+
+Population::Population()
+{
+  verweisen();
+}
+
+Population::Population(Population const& p)
+: namen_{p.namen_}
+, name_{p.name_}
+, geschlecht_{p.geschlecht_}
+, art_{p.art_}
+, eigen_{p.eigen_}
+, wunsch_{p.wunsch_}
+, halter_{p.halter_}
+, spalten_{p.spalten_}
+{
+  if (!halter_) verweisen();
+}
+
+Population::Population(Population&& p) noexcept
+: namen_{std::move(p.namen_)}
+, name_{std::move(p.name_)}
+, geschlecht_{std::move(p.geschlecht_)}
+, art_{std::move(p.art_)}
+, eigen_{std::move(p.eigen_)}
+, wunsch_{std::move(p.wunsch_)}
+, halter_{std::move(p.halter_)}
+, spalten_{p.spalten_}
+{
+  if (!halter_) verweisen();
+  p.namen_ = Namen();
+  p.halter_.reset();
+  p.verweisen();
+}
+
+Population& Population::operator=(Population p) noexcept
+{
+  namen_ = std::move(p.namen_);
+  name_ = std::move(p.name_);
+  geschlecht_ = std::move(p.geschlecht_);
+  art_ = std::move(p.art_);
+  eigen_ = std::move(p.eigen_);
+  wunsch_ = std::move(p.wunsch_);
+  halter_ = std::move(p.halter_);
+  spalten_ = p.spalten_;
+  if (!halter_) verweisen();
+  return *this;
+}
+
+Population::Population(Spalten const& spalten, std::shared_ptr<void const> halter)
+: halter_{std::move(halter)}
+, spalten_{spalten}
+{
+}
+
+Population::Index Population::hinzufuegen(std::string_view name, char geschlecht,
+                                          Profil eigen, Profil wunsch, Art art)
+{
+  if (halter_) throw std::logic_error("Population: ein Abbild ist nur lesbar");
+  name_.push_back(namen_.intern(name));
+  geschlecht_.push_back(geschlecht);
+  art_.push_back(art);
+  eigen_.push_back(eigen);
+  wunsch_.push_back(wunsch);
+  verweisen();
+  return Index(size() - 1);
+}
+
+void Population::aendern(Index i, Profil eigen, Profil wunsch)
+{
+  if (halter_) throw std::logic_error("Population: ein Abbild ist nur lesbar");
+  eigen_.setzen(i, eigen);
+  wunsch_.setzen(i, wunsch);
+}
+
+void Population::reserve(size_t n)
+{
+  namen_.reserve(n, 8 * n);
+  name_.reserve(n);
+  geschlecht_.reserve(n);
+  art_.reserve(n);
+  for (auto profile : {&eigen_, &wunsch_})
+  {
+    profile->alter.reserve(n);
+    profile->groesse.reserve(n);
+    profile->vermoegen.reserve(n);
+  }
+  verweisen();
+}
+
+void Population::verweisen()
+{
+  spalten_.size = name_.size();
+  spalten_.name = name_.data();
+  spalten_.geschlecht = geschlecht_.data();
+  spalten_.art = art_.data();
+  spalten_.eigen = eigen_.spalten();
+  spalten_.wunsch = wunsch_.spalten();
+  spalten_.namen_anfang = namen_.anfang().data();
+  spalten_.namen_zeichen = namen_.zeichen().data();
+  spalten_.namen = namen_.size();
+}
+
+Profil Population::gesehen(Index i, Index j) const
+{
+  auto profil = eigen()[j];
+  if (art(j) == Art::schwindler)
+  {
+    profil.alter = wunsch().alter[i];
+    profil.vermoegen = wunsch().vermoegen[i];
+  }
+  return profil;
+}
+
+bool Population::akzeptiert(Index i, Profil gesehen) const
+{
+  switch (art(i))
+  {
+  case Art::bescheiden:    return true;
+  case Art::schwindler:    return gesehen.vermoegen > 50000;
+  case Art::anspruchsvoll: return abweichung(wunsch()[i], gesehen) < 0.10;
+  default:                 return abweichung(wunsch()[i], gesehen) < 0.25;
+  }
+}
+
+double Population::bewertung(Index i, Profil gesehen) const
+{
+  if (art(i) == Art::schwindler) return -gesehen.vermoegen;
+  return abweichung(wunsch()[i], gesehen);
+}
+
+double toleranz(Art art)
+{
+  switch (art)
+  {
+  case Art::anspruchsvoll: return 0.10;
+  case Art::gewoehnlich:   return 0.25;
+  default:                 return HUGE_VAL; // das Alter spielt keine Rolle
+  }
+}
+
+// ===[ Praeferenzlisten ]=========================================
+
+namespace
+{
+
+using Index = Population::Index;
+
+// Praeferenzlisten aller Antragsteller hintereinander (compressed sparse rows)
+struct Praeferenzen
+{
+  std::vector<size_t> anfang;     // Liste von Antragsteller a: [anfang[a], anfang[a+1])
+  std::vector<Index> kandidaten;
+};
+
+// f(teil, anfang, ende) fuer gleich grosse Teile von [0, n), mit Pool parallel
+template <typename F>
+void stueckweise(ThreadPool* pool, size_t n, size_t teile, F f)
+{
+  if (!pool || teile < 2)
+  {
+    f(size_t(0), size_t(0), n);
+    return;
+  }
+  TaskGroup gruppe{*pool};
+  for (size_t t = 0; t < teile; ++t)
+    gruppe.run([=, &f] { f(t, n * t / teile, n * (t + 1) / teile); });
+  gruppe.wait();
+}
+
+size_t anzahl_teile(Optionen const& optionen, size_t n)
+{
+  // mehrere Teile je Thread, damit das Stehlen die Last ausgleicht
+  if (!optionen.pool) return 1;
+  if (optionen.teile) return optionen.teile;
+  return std::clamp<size_t>(n / 1024, 1, 8 * optionen.pool->size());
+}
+
+Praeferenzen praeferenzen(Population const& p, std::vector<Index> const& antragsteller,
+                          std::vector<Index> const& empfaenger, Optionen const& optionen)
+{
+  // Eine Heiratsschwindlerin zeigt jedem Antragsteller dessen Wunschalter und
+  // -vermoegen, nur ihre Groesse ist fest: sie steht nach Groesse sortiert
+  // neben dem Index, alle anderen stehen im Index
+  std::vector<Profil> profile;
+  std::vector<Index> indizes;
+  std::vector<std::pair<double, Index>> schwindlerinnen;
+  for (auto e : empfaenger)
+  {
+    if (p.art(e) == Art::schwindler) schwindlerinnen.emplace_back(p.eigen().groesse[e], e);
+    else
+    {
+      profile.push_back(p.eigen()[e]);
+      indizes.push_back(e);
+    }
+  }
+  std::sort(begin(schwindlerinnen), end(schwindlerinnen));
+  auto index = ProfilIndex(profile, indizes);
+
+  auto nach_vermoegen = indizes;
+  std::sort(begin(nach_vermoegen), end(nach_vermoegen), [&](Index a, Index b)
+  {
+    auto va = p.eigen().vermoegen[a], vb = p.eigen().vermoegen[b];
+    return va != vb ? va > vb : a < b;
+  });
+
+  // jeder Teil der Antragsteller fuellt seine eigenen Listen, danach werden
+  // sie in der Reihenfolge der Antragsteller aneinandergehaengt
+  auto k = optionen.praeferenzen;
+  auto teile = anzahl_teile(optionen, antragsteller.size());
+  std::vector<Praeferenzen> listen(teile);
+  stueckweise(optionen.pool, antragsteller.size(), teile, [&](size_t t, size_t anfang, size_t ende)
+  {
+    auto& teil = listen[t];
+    teil.anfang.reserve(ende - anfang);
+    teil.kandidaten.reserve((ende - anfang) * k);
+
+    std::vector<std::pair<double, Index>> beste, kandidaten;
+    for (auto i = anfang; i < ende; ++i)
+    {
+      auto a = antragsteller[i];
+      teil.anfang.push_back(teil.kandidaten.size());
+      kandidaten.clear();
+
+      auto pruefen = [&](Index e)
+      {
+        auto profil = p.gesehen(a, e);
+        if (p.akzeptiert(a, profil)) kandidaten.emplace_back(p.bewertung(a, profil), e);
+      };
+
+      if (p.art(a) == Art::schwindler)
+      {
+        // die reichsten zuerst, jede reichere Frau ist besser als jede aermere
+        for (size_t j = 0; j < nach_vermoegen.size() && kandidaten.size() < k; ++j) pruefen(nach_vermoegen[j]);
+        for (size_t j = 0; j < schwindlerinnen.size() && j < k; ++j) pruefen(schwindlerinnen[j].second);
+      }
+      else
+      {
+        index.beste(p.wunsch()[a], toleranz(p.art(a)), k, beste);
+        kandidaten = beste;
+
+        // Schwindlerinnen: die Abweichung waechst mit dem Groessenunterschied
+        auto wg = p.wunsch().groesse[a];
+        auto rechts = size_t(std::lower_bound(begin(schwindlerinnen), end(schwindlerinnen), std::pair{wg, Index(0)})
+                             - begin(schwindlerinnen));
+        auto links = rechts;
+        for (size_t n = 0; n < k; ++n)
+        {
+          auto links_ok = links > 0;
+          auto rechts_ok = rechts < schwindlerinnen.size();
+          if (!links_ok && !rechts_ok) break;
+          if (links_ok && (!rechts_ok || wg - schwindlerinnen[links - 1].first <= schwindlerinnen[rechts].first - wg))
+            pruefen(schwindlerinnen[--links].second);
+          else
+            pruefen(schwindlerinnen[rechts++].second);
+        }
+      }
+
+      auto n = std::min(kandidaten.size(), k);
+      std::partial_sort(begin(kandidaten), begin(kandidaten) + n, end(kandidaten));
+      for (size_t j = 0; j < n; ++j) teil.kandidaten.push_back(kandidaten[j].second);
+    }
+  });
+
+  if (teile == 1)
+  {
+    listen[0].anfang.push_back(listen[0].kandidaten.size());
+    return std::move(listen[0]);
+  }
+
+  Praeferenzen result;
+  size_t gesamt = 0;
+  for (auto const& teil : listen) gesamt += teil.kandidaten.size();
+  result.anfang.reserve(antragsteller.size() + 1);
+  result.kandidaten.reserve(gesamt);
+  for (auto const& teil : listen)
+  {
+    auto versatz = result.kandidaten.size();
+    for (auto a : teil.anfang) result.anfang.push_back(versatz + a);
+    result.kandidaten.insert(end(result.kandidaten), begin(teil.kandidaten), end(teil.kandidaten));
+  }
+  result.anfang.push_back(result.kandidaten.size());
+  return result;
+}
+
+} // namespace
+
+// ===[ Gale-Shapley ]=============================================
+
+Paarung vermitteln(Population const& p, Optionen const& optionen)
+{
+  std::vector<Index> maenner, frauen;
+  for (Index i = 0; i < p.size(); ++i) (p.geschlecht(i) == 'm' ? maenner : frauen).push_back(i);
+
+  auto listen = praeferenzen(p, maenner, frauen, optionen);
+
+  // verlobt[frau] wird nur per compare-exchange geaendert; naechster[a] gehoert
+  // dem Thread, der gerade fuer den Mann a Antraege macht
+  std::vector<std::atomic<Index>> verlobt(p.size());
+  for (auto& v : verlobt) v.store(Paarung::kein, std::memory_order_relaxed);
+  std::vector<size_t> naechster(begin(listen.anfang), end(listen.anfang) - 1);
+  std::vector<Index> platz(p.size());
+  for (Index a = 0; a < maenner.size(); ++a) platz[maenner[a]] = a;
+
+  auto teile = anzahl_teile(optionen, maenner.size());
+  std::vector<size_t> antraege(teile);
+  stueckweise(optionen.pool, maenner.size(), teile, [&](size_t t, size_t anfang, size_t ende)
+  {
+    size_t gezaehlt = 0;
+    for (auto start = anfang; start < ende; ++start)
+    {
+      // wer verdraengt wird, macht auf diesem Thread weiter
+      auto a = Index(start);
+      while (a != Paarung::kein)
+      {
+        auto mann = maenner[a];
+        auto verdraengt = Paarung::kein;
+        while (naechster[a] < listen.anfang[a + 1])
+        {
+          auto frau = listen.kandidaten[naechster[a]++];
+          ++gezaehlt;
+          if (!p.akzeptiert(frau, mann)) continue;
+
+          auto bisher = verlobt[frau].load(std::memory_order_acquire);
+          auto angenommen = false;
+          while (bisher == Paarung::kein || p.besser(frau, mann, bisher))
+          {
+            // der Erfolg gibt naechster[a] an den frei, der mann spaeter verdraengt
+            if (verlobt[frau].compare_exchange_weak(bisher, mann, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire))
+            {
+              angenommen = true;
+              break;
+            }
+          }
+          if (!angenommen) continue;
+          verdraengt = bisher;
+          break;
+        }
+        a = verdraengt == Paarung::kein ? Paarung::kein : platz[verdraengt];
+      }
+    }
+    antraege[t] = gezaehlt;
+  });
+
+  Paarung result;
+  result.partner.assign(p.size(), Paarung::kein);
+  for (auto frau : frauen)
+  {
+    auto mann = verlobt[frau].load(std::memory_order_relaxed);
+    if (mann == Paarung::kein) continue;
+    result.partner[frau] = mann;
+    result.partner[mann] = frau;
+    ++result.paare;
+  }
+  for (auto n : antraege) result.antraege += n;
+  return result;
+}
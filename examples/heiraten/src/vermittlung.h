@@ -0,0 +1,138 @@
+//: vermittlung.h : Partnervermittlung fuer Millionen von Singles
+
+#ifndef VERMITTLUNG_H
+#define VERMITTLUNG_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "abweichung.h"
+#include "namen.h"
+#include "single.h"
+
+class ThreadPool;
+
+// Die Regeln der Klassen aus single.h und sonder.h als Daten
+enum class Art : unsigned char
+{
+  gewoehnlich,    // Single
+  anspruchsvoll,  // AnspruchsvollerSingle
+  bescheiden,     // BescheidenerSingle
+  schwindler      // Heiratsschwindler
+};
+
+class Population
+{
+public:
+  using Index = uint32_t;
+
+  // alle Spalten ohne Besitz: aus den eigenen Vektoren oder aus einem Abbild
+  struct Spalten
+  {
+    size_t size = 0;
+    Namen::Nummer const* name = nullptr;
+    char const* geschlecht = nullptr;
+    Art const* art = nullptr;
+    ProfilSpalten eigen, wunsch;
+    uint64_t const* namen_anfang = nullptr;   // wie Namen::anfang() und zeichen()
+    char const* namen_zeichen = nullptr;
+    size_t namen = 0;
+  };
+
+  Population();
+  Population(Population const& p);
+  Population(Population&& p) noexcept;
+  Population& operator=(Population p) noexcept;
+
+  // liest direkt aus fremdem Speicher, etwa einem abgebildeten Schnappschuss;
+  // halter haelt ihn am Leben, hinzufuegen() geht dann nicht mehr
+  Population(Spalten const& spalten, std::shared_ptr<void const> halter);
+
+  Index hinzufuegen(std::string_view name, char geschlecht, Profil eigen, Profil wunsch,
+                    Art art = Art::gewoehnlich);
+  void aendern(Index i, Profil eigen, Profil wunsch);
+  void reserve(size_t n);
+
+  auto size()               const { return spalten_.size; }
+  auto geschlecht(Index i)  const { return spalten_.geschlecht[i]; }
+  auto art(Index i)         const { return spalten_.art[i]; }
+  auto const& eigen()       const { return spalten_.eigen; }
+  auto const& wunsch()      const { return spalten_.wunsch; }
+  auto const& spalten()     const { return spalten_; }
+
+  std::string_view name(Index i) const
+  {
+    auto n = spalten_.name[i];
+    auto anfang = spalten_.namen_anfang[n];
+    return {spalten_.namen_zeichen + anfang, size_t(spalten_.namen_anfang[n + 1] - anfang)};
+  }
+
+  // das Profil von j, wie es sich i praesentiert: der Heiratsschwindler
+  // passt Alter und Vermoegen an die Wuensche von i an
+  Profil gesehen(Index i, Index j) const;
+
+  // Single::akzeptiert und die Bewertung in Single::verbesserung
+  // (kleiner ist besser) aus der Sicht von i
+  bool akzeptiert(Index i, Index j) const { return akzeptiert(i, gesehen(i, j)); }
+  double bewertung(Index i, Index j) const { return bewertung(i, gesehen(i, j)); }
+  bool akzeptiert(Index i, Profil gesehen) const;
+  double bewertung(Index i, Profil gesehen) const;
+
+  // zieht i neu bisher vor? bessere Bewertung, bei Gleichstand der kleinere Index
+  bool besser(Index i, Index neu, Index bisher) const
+  {
+    auto bn = bewertung(i, neu), bb = bewertung(i, bisher);
+    return bn < bb || (bn == bb && neu < bisher);
+  }
+
+private:
+  void verweisen();   // spalten_ auf die eigenen Vektoren
+
+  Namen namen_;
+  std::vector<Namen::Nummer> name_;
+  std::vector<char> geschlecht_;
+  std::vector<Art> art_;
+  Profile eigen_, wunsch_;
+
+  std::shared_ptr<void const> halter_;   // fremder Speicher, sonst leer
+  Spalten spalten_;
+};
+
+// die Toleranz von Population::akzeptiert() als Suchradius im ProfilIndex,
+// unendlich fuer Arten, die nicht nach der Abweichung gehen
+double toleranz(Art art);
+
+struct Optionen
+{
+  size_t praeferenzen = 16;     // Laenge der Praeferenzliste je Antragsteller
+  ThreadPool* pool = nullptr;   // Praeferenzlisten und Antraege parallel im Pool
+  size_t teile = 0;             // Teile je Schritt im Pool, 0: einer je 1024 Antragsteller
+};
+
+struct Paarung
+{
+  static constexpr auto kein = Population::Index(-1);
+
+  std::vector<Population::Index> partner;   // partner[i] oder kein
+  size_t antraege = 0;
+  size_t paare = 0;
+};
+
+// Gale-Shapley: die Maenner gehen ihre Praeferenzlisten (die besten akzeptierten
+// Frauen) der Reihe nach durch, eine Frau wechselt nur bei einer Verbesserung.
+// Die Praeferenzlisten sind die besten akzeptierten Frauen, gesucht im
+// ProfilIndex (fuer den Heiratsschwindler: die reichsten Frauen), bei
+// Gleichstand mit dem kleineren Index. Heiratsschwindlerinnen kommen nach dem
+// Groessenunterschied hinzu: teilen sich mehrere den letzten Platz der Liste,
+// entscheidet die Groesse, welche darauf kommen, nicht der Index wie in
+// Population::besser.
+//
+// Mit optionen.pool machen mehrere Threads gleichzeitig Antraege: der Partner
+// einer Frau ist ein atomarer Platz, den ein Antrag per compare-exchange
+// uebernimmt. Bei gleicher Bewertung gewinnt der kleinere Index, die
+// Reihenfolge ist dann strikt und das Ergebnis (Paare und Antraege) haengt
+// nicht von der Zahl der Threads ab.
+Paarung vermitteln(Population const& p, Optionen const& optionen = {});
+
+#endif // VERMITTLUNG_H
@@ -0,0 +1,89 @@
+//: vermittlung_bench.cpp : Objektversion und Batch-Vermittlung im Vergleich
+// g++ -std=c++17 -O2 -march=native -pthread vermittlung_bench.cpp vermittlung.cpp namen.cpp profilindex.cpp abweichung.cpp single.cpp protokoll.cpp sonder.cpp
+//
+// vermittlung_bench [max_size=1e7]
+// 1. das Beispiel aus output.txt: beide Versionen muessen dieselben Paare bilden
+// 2. Durchsatz der Batch-Vermittlung fuer 10^4 .. max_size Singles
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "beispiel.h"
+#include "single.h"
+#include "sonder.h"
+#include "vermittlung.h"
+
+// die Paare der Objektversion, wie ausgabe() sie meldet
+std::string objektversion()
+{
+  Single anton("Anton", 'm', Profil(55, 1.75, 100000), Profil(50, 1.70, 0));
+  Single berta("Berta", 'w', Profil(50, 1.70, 60000), Profil(50, 1.80, 10000));
+  Heiratsschwindler claus("Claus", 'm', Profil(30, 1.80, 100000), Profil(25, 1.70, 0));
+  AnspruchsvollerSingle doris("Doris", 'w', Profil(60, 1.65, 100000), Profil(65, 1.80, 10000));
+  BescheidenerSingle ernst("Ernst", 'm', Profil(50, 1.80, 8000), Profil(50, 1.80, 20000));
+
+  std::vector<Single*> maenner{&anton, &claus, &ernst};
+  std::vector<Single*> frauen{&berta, &doris};
+
+  // das Protokoll schreibt im Hintergrund: vor jedem Umschalten leeren
+  std::ostringstream protokoll, paare;
+  protokoll::leeren();
+  auto alt = std::cout.rdbuf(protokoll.rdbuf());
+  for (auto m : maenner)
+    for (auto f : frauen) m->angebot(f);
+  for (auto f : frauen)
+    for (auto m : maenner) f->angebot(m);
+
+  protokoll::leeren();
+  std::cout.rdbuf(paare.rdbuf());
+  for (auto m : maenner) m->ausgabe();
+  for (auto f : frauen) f->ausgabe();
+  protokoll::leeren();
+  std::cout.rdbuf(alt);
+  return paare.str();
+}
+
+std::string batchversion()
+{
+  auto p = beispiel();
+  auto paarung = vermitteln(p);
+
+  std::ostringstream paare;
+  for (char geschlecht : {'m', 'w'})
+    for (Population::Index i = 0; i < p.size(); ++i)
+      if (p.geschlecht(i) == geschlecht)
+      {
+        auto partner = paarung.partner[i];
+        paare << p.name(i) << " == " << (partner == Paarung::kein ? "-" : p.name(partner)) << '\n';
+      }
+  return paare.str();
+}
+
+int main(int argc, char* argv[])
+{
+  auto objekt = objektversion();
+  auto batch = batchversion();
+  std::cout << "Objektversion:\n" << objekt << "Batchversion:\n" << batch
+            << (objekt == batch ? "gleiche Paare\n\n" : "VERSCHIEDENE Paare\n\n");
+  if (objekt != batch) return 1;
+
+  auto max_size = bench::max_size(argc, argv, 10'000'000);
+  std::printf("%10s %12s %12s %10s %10s %14s\n", "Singles", "Antraege", "Paare", "Aufbau [s]", "Lauf [s]", "Singles/s");
+  for (size_t n = 10'000; n <= max_size; n *= 10)
+  {
+    auto start = bench::Clock::now();
+    auto p = zufaellig(n);
+    auto mitte = bench::Clock::now();
+    auto paarung = vermitteln(p);
+    auto ende = bench::Clock::now();
+
+    auto aufbau = bench::Seconds{mitte - start}.count();
+    auto lauf = bench::Seconds{ende - mitte}.count();
+    std::printf("%10zu %12zu %12zu %10.3f %10.3f %14.0f\n", n, paarung.antraege, paarung.paare, aufbau, lauf, n / lauf);
+  }
+}
@@ -0,0 +1,110 @@
+//: vermittlung_parallel_bench.cpp : parallele Vermittlung, Stresstest und Skalierung
+// g++ -std=c++17 -O2 -march=native -pthread vermittlung_parallel_bench.cpp vermittlung.cpp namen.cpp profilindex.cpp abweichung.cpp single.cpp protokoll.cpp
+// mit ThreadSanitizer: dieselbe Zeile mit -O1 -g -fsanitize=thread
+//
+// vermittlung_parallel_bench [singles=1000000] [max_threads=hardware_concurrency]
+// 1. Stresstest: viele kleine Populationen mit vielen gleichen Profilen (also
+//    Gleichstaenden und Wettlaeufen um dieselben Frauen), parallel vermittelt
+//    mit mehr Threads als Kernen und 4 Teilen je Thread, auch wenn die Populationen
+//    dafuer zu klein sind; das Ergebnis muss dem sequentiellen gleichen
+// 2. Skalierung: Laufzeit fuer 1 .. max_threads Threads
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "../../benchmarking/bench.hpp"
+#include "../../concurrency/thread_pool.hpp"
+#include "beispiel.h"
+#include "vermittlung.h"
+
+// wenige verschiedene Werte: viele Frauen sind fuer viele Maenner gleich gut
+Population grob(size_t n, uint64_t seed)
+{
+  bench::Xoshiro256 generator{seed};
+  auto wahl = [&](uint64_t bereich) { return bench::bounded(generator(), bereich); };
+
+  Population p;
+  p.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    auto eigen = Profil(30 + int(wahl(3)), 1.60 + 0.1 * wahl(3), 10000.0 * wahl(4));
+    auto wunsch = Profil(30 + int(wahl(3)), 1.60 + 0.1 * wahl(3), 10000.0 * wahl(3));
+    p.hinzufuegen("S" + std::to_string(i), wahl(2) ? 'w' : 'm', eigen, wunsch, Art(wahl(4)));
+  }
+  return p;
+}
+
+// jeder Partner hat den anderen als Partner, und nur Mann mit Frau
+bool konsistent(Population const& p, Paarung const& paarung)
+{
+  size_t paare = 0;
+  for (Population::Index i = 0; i < p.size(); ++i)
+  {
+    auto j = paarung.partner[i];
+    if (j == Paarung::kein) continue;
+    if (paarung.partner[j] != i || p.geschlecht(i) == p.geschlecht(j)) return false;
+    paare += p.geschlecht(i) == 'w';
+  }
+  return paare == paarung.paare;
+}
+
+bool stresstest(unsigned threads)
+{
+  ThreadPool pool{threads};
+  auto parallel = Optionen{};
+  parallel.pool = &pool;
+  parallel.teile = 4 * pool.size();
+  parallel.praeferenzen = 64;
+  auto sequentiell = Optionen{};
+  sequentiell.praeferenzen = parallel.praeferenzen;
+
+  for (uint64_t seed = 1; seed <= 200; ++seed)
+  {
+    auto p = grob(500 + 100 * (seed % 20), seed);
+    auto erwartet = vermitteln(p, sequentiell);
+    for (int wiederholung = 0; wiederholung < 5; ++wiederholung)
+    {
+      auto paarung = vermitteln(p, parallel);
+      if (paarung.partner != erwartet.partner || paarung.antraege != erwartet.antraege || !konsistent(p, paarung))
+      {
+        std::printf("Stresstest: seed %llu, %u Threads: Ergebnis weicht ab\n", (unsigned long long)seed, threads);
+        return false;
+      }
+    }
+  }
+  std::printf("Stresstest: 200 Populationen x 5 Laeufe mit %u Threads in %zu Teilen wie sequentiell\n\n",
+              threads, parallel.teile);
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  if (!stresstest(std::max(8u, 2 * std::thread::hardware_concurrency()))) return 1;
+
+  auto singles = bench::max_size(argc, argv, 1'000'000);
+  auto max_threads = bench::max_threads(argc, argv);
+
+  auto p = zufaellig(singles);
+  Paarung erwartet;
+  auto basis = bench::seconds([&] { erwartet = vermitteln(p); });
+  std::printf("%zu Singles, %zu Paare, %zu Antraege, sequentiell %.3f s\n\n",
+              singles, erwartet.paare, erwartet.antraege, basis);
+
+  std::printf("%8s %10s %10s %10s\n", "Threads", "Lauf [s]", "Speedup", "Effizienz");
+  for (auto threads : bench::thread_counts(max_threads))
+  {
+    ThreadPool pool{threads};
+    auto optionen = Optionen{};
+    optionen.pool = &pool;
+
+    Paarung paarung;
+    auto lauf = bench::seconds([&] { paarung = vermitteln(p, optionen); });
+    if (paarung.partner != erwartet.partner)
+    {
+      std::printf("%u Threads: andere Paare als sequentiell\n", threads);
+      return 1;
+    }
+    std::printf("%8u %10.3f %10.2f %9.0f%%\n", threads, lauf, basis / lauf, 100 * basis / lauf / threads);
+  }
+}
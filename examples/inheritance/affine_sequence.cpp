@@ -0,0 +1,41 @@
+#include <limits>
+#include "affine_sequence.hpp"
+#include "scan.hpp"
+
+AffineSequence::AffineSequence(Number start, Number factor, Number step)
+: Sequence{start}
+, step_{factor, step}
+{
+}
+
+void AffineSequence::next() { current_ = step_(current_); }
+
+// the same values as next(), without a virtual call per value
+void AffineSequence::fill(std::span<Number> out)
+{
+    for (auto& x : out)
+    {
+        x = current_;
+        current_ = step_(current_);
+    }
+}
+
+void AffineSequence::fill(std::span<Number> out, ThreadPool& pool, std::size_t chunks)
+{
+    if (out.empty()) return;
+    if (chunks == 0) chunks = 4 * pool.size();   // a few per thread, stealing evens them out
+
+    auto step = step_;
+    parallel_scan(pool, current_, out,
+        [step](std::size_t) { return step; },
+        [step](std::size_t first, std::size_t last) { return power(step, last - first); },
+        chunks);
+    current_ = step_(out.back());
+}
+
+double AffineSequence::error_bound(std::size_t i, std::size_t chunks, Number s)
+{
+    auto const u = std::numeric_limits<double>::epsilon() / 2;
+    auto k = (2.0 * double(i) + 2.0 * double(chunks)) * u;   // gamma(2i + 2C)
+    return 2 * k / (1 - k) * s;
+}
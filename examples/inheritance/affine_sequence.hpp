@@ -0,0 +1,47 @@
+#ifndef AFFINE_SEQUENCE_HPP
+#define AFFINE_SEQUENCE_HPP
+
+#include <cstddef>
+#include "sequence.hpp"
+
+class ThreadPool;
+
+// x -> a * x + b; composing two of them gives another one
+struct Affine
+{
+    Sequence::Number a = 1, b = 0;
+
+    Sequence::Number operator()(Sequence::Number x) const { return a * x + b; }
+
+    // first f, then g
+    friend Affine then(Affine f, Affine g) { return {g.a * f.a, g.a * f.b + g.b}; }
+};
+
+// x[n+1] = factor * x[n] + step: factor 1 gives an ArithmeticSequence,
+// step 0 a GeometricSequence
+//
+// fill(out, pool) splits out into chunks (see scan.hpp) and differs from
+// the serial values of next() only by rounding. Let S[i] be the same
+// recurrence with |start|, |factor|, |step|, u = 2^-53 and C the number
+// of chunks. Serially every term a^k * b of x[i] is rounded at most 2i
+// times; in parallel, with the chunk maps from power(), at most 2i + 2C
+// times. So both are within gamma(2i + 2C) * S[i] of the exact value,
+// gamma(k) = k*u / (1 - k*u), and
+//   |parallel[i] - serial[i]| <= 2 * gamma(2i + 2C) * S[i]
+// which is about 4i * u * S[i]: 10^9 terms keep about 6 significant
+// digits of S. S[i] equals |x[i]| when start, factor and step are not
+// negative; with changing signs, cancellation makes the relative error larger.
+class AffineSequence : public Sequence
+{
+public:
+    AffineSequence(Number start, Number factor, Number step);
+    void next() override;
+    void fill(std::span<Number> out) override;
+    void fill(std::span<Number> out, ThreadPool& pool, std::size_t chunks = 0);
+
+    static double error_bound(std::size_t i, std::size_t chunks, Number s);
+private:
+    Affine step_;
+};
+
+#endif
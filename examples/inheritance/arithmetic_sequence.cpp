@@ -1,4 +1,5 @@
 #include "arithmetic_sequence.hpp"
+#include "lanes.hpp"
 
 ArithmeticSequence::ArithmeticSequence(Number start, Number step)
 : Sequence{start}
@@ -6,4 +7,27 @@ ArithmeticSequence::ArithmeticSequence(Number start, Number step)
 {
 }
 
-void ArithmeticSequence::next() { current_ += step_; }
\ No newline at end of file
+void ArithmeticSequence::next() { current_ += step_; }
+
+// start + i * step for every term, nothing carried from one term to the next
+void ArithmeticSequence::fill(std::span<Number> out)
+{
+    auto const n = out.size();
+    Number first[Lanes::width];
+    for (std::size_t j = 0; j < Lanes::width; ++j) first[j] = Number(j);
+
+    auto const start = Lanes::broadcast(current_);
+    auto const step = Lanes::broadcast(step_);
+    auto const stride = Lanes::broadcast(Number(Lanes::width));
+    auto index = Lanes::load(first);
+
+    std::size_t i = 0;
+    for (; i + Lanes::width <= n; i += Lanes::width)
+    {
+        (start + index * step).store(out.data() + i);
+        index = index + stride;
+    }
+    for (; i < n; ++i) out[i] = current_ + Number(i) * step_;
+
+    current_ += Number(n) * step_;
+}
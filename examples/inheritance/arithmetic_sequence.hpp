@@ -8,6 +8,7 @@ class ArithmeticSequence : public Sequence
 public:
     ArithmeticSequence(Number start, Number step);
     void next() override;
+    void fill(std::span<Number> out) override;
 private:    
     Number step_;
 };
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include "geometric_sequence.hpp"
+#include "lanes.hpp"
 
 GeometricSequence::GeometricSequence(Number start, Number factor)
 : Sequence{start}
@@ -6,4 +9,33 @@ GeometricSequence::GeometricSequence(Number start, Number factor)
 {
 }
 
-void GeometricSequence::next() { current_ *= factor_; }
\ No newline at end of file
+void GeometricSequence::next() { current_ *= factor_; }
+
+// start * factor^i: std::pow for each lane at the beginning of a block, then one
+// multiplication by factor^width per step, so rounding errors cannot pile up
+// over more than a block (next() accumulates them over the whole sequence)
+void GeometricSequence::fill(std::span<Number> out)
+{
+    constexpr std::size_t block = 1024;
+    auto const n = out.size();
+    auto const stride = Lanes::broadcast(std::pow(factor_, Number(Lanes::width)));
+
+    for (std::size_t begin = 0; begin < n; begin += block)
+    {
+        auto const end = std::min(n, begin + block);
+        Number terms[Lanes::width];
+        for (std::size_t j = 0; j < Lanes::width; ++j) terms[j] = current_ * std::pow(factor_, Number(begin + j));
+        auto term = Lanes::load(terms);
+
+        auto i = begin;
+        for (; i + Lanes::width <= end; i += Lanes::width)
+        {
+            term.store(out.data() + i);
+            term = term * stride;
+        }
+        term.store(terms);
+        for (std::size_t j = 0; i < end; ++i, ++j) out[i] = terms[j];
+    }
+
+    current_ *= std::pow(factor_, Number(n));
+}
@@ -8,6 +8,7 @@ class GeometricSequence : public Sequence
 public:
     GeometricSequence(Number start, Number factor);
     void next() override;
+    void fill(std::span<Number> out) override;
 private:    
     Number factor_;
 };
@@ -0,0 +1,75 @@
+#ifndef LANES_HPP
+#define LANES_HPP
+
+#include <cstddef>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Lanes::width doubles side by side, one instruction for all of them:
+// AVX-512 (8), AVX (4), SSE2 (2), whatever the compiler may use, else one
+
+#if defined(__AVX512F__)
+
+struct Lanes
+{
+	static constexpr std::size_t width = 8;
+	__m512d v;
+
+	static Lanes broadcast(double x) { return {_mm512_set1_pd(x)}; }
+	static Lanes load(double const* p) { return {_mm512_loadu_pd(p)}; }
+	void store(double* p) const { _mm512_storeu_pd(p, v); }
+
+	friend Lanes operator+(Lanes a, Lanes b) { return {_mm512_add_pd(a.v, b.v)}; }
+	friend Lanes operator*(Lanes a, Lanes b) { return {_mm512_mul_pd(a.v, b.v)}; }
+};
+
+#elif defined(__AVX__)
+
+struct Lanes
+{
+	static constexpr std::size_t width = 4;
+	__m256d v;
+
+	static Lanes broadcast(double x) { return {_mm256_set1_pd(x)}; }
+	static Lanes load(double const* p) { return {_mm256_loadu_pd(p)}; }
+	void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+	friend Lanes operator+(Lanes a, Lanes b) { return {_mm256_add_pd(a.v, b.v)}; }
+	friend Lanes operator*(Lanes a, Lanes b) { return {_mm256_mul_pd(a.v, b.v)}; }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+struct Lanes
+{
+	static constexpr std::size_t width = 2;
+	__m128d v;
+
+	static Lanes broadcast(double x) { return {_mm_set1_pd(x)}; }
+	static Lanes load(double const* p) { return {_mm_loadu_pd(p)}; }
+	void store(double* p) const { _mm_storeu_pd(p, v); }
+
+	friend Lanes operator+(Lanes a, Lanes b) { return {_mm_add_pd(a.v, b.v)}; }
+	friend Lanes operator*(Lanes a, Lanes b) { return {_mm_mul_pd(a.v, b.v)}; }
+};
+
+#else
+
+struct Lanes
+{
+	static constexpr std::size_t width = 1;
+	double v;
+
+	static Lanes broadcast(double x) { return {x}; }
+	static Lanes load(double const* p) { return {*p}; }
+	void store(double* p) const { *p = v; }
+
+	friend Lanes operator+(Lanes a, Lanes b) { return {a.v + b.v}; }
+	friend Lanes operator*(Lanes a, Lanes b) { return {a.v * b.v}; }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+// Parallel prefix scan for recurrences x[i + 1] = step(i)(x[i]).
+//
+// A step is a map M that can be applied, m(x), and composed: then(f, g) is
+// "first f, then g" and must be associative. The range is cut into chunks:
+//   1. in parallel: the composed map of each chunk
+//   2. serially:    the first value of each chunk, applying the chunk maps
+//   3. in parallel: the values inside each chunk, one step at a time
+// The serial part is one map application per chunk.
+
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "../concurrency/thread_pool.hpp"
+
+// f repeated n times by squaring, M{} is the identity
+template <typename M>
+M power(M f, std::size_t n)
+{
+    auto result = M{};
+    for (; n; n >>= 1)
+    {
+        if (n & 1) result = then(result, f);
+        f = then(f, f);
+    }
+    return result;
+}
+
+// out[0] = start, out[i + 1] = step_at(i)(out[i]);
+// chunk_map(first, last) composes step_at(first) .. step_at(last - 1)
+template <typename T, typename StepAt, typename ChunkMap>
+void parallel_scan(ThreadPool& pool, T start, std::span<T> out, StepAt step_at, ChunkMap chunk_map,
+                   std::size_t chunks)
+{
+    auto const n = out.size();
+    if (n == 0) return;
+    chunks = std::max<std::size_t>(1, std::min(chunks, n));
+    auto first = [&](std::size_t c) { return n * c / chunks; };
+
+    using M = decltype(chunk_map(std::size_t{}, std::size_t{}));
+    std::vector<M> maps(chunks - 1);
+    parallel_for(pool, chunks - 1, chunks - 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (auto c = begin; c < end; ++c) maps[c] = chunk_map(first(c), first(c + 1));
+    });
+
+    std::vector<T> starts(chunks);
+    starts[0] = start;
+    for (std::size_t c = 1; c < chunks; ++c) starts[c] = maps[c - 1](starts[c - 1]);
+
+    parallel_for(pool, chunks, chunks, [&](std::size_t begin, std::size_t end)
+    {
+        for (auto c = begin; c < end; ++c)
+        {
+            auto x = starts[c];
+            out[first(c)] = x;
+            for (auto i = first(c) + 1; i < first(c + 1); ++i) out[i] = x = step_at(i - 1)(x);
+        }
+    });
+}
+
+// any recurrence: the chunk maps are composed step by step
+template <typename T, typename StepAt>
+void parallel_scan(ThreadPool& pool, T start, std::span<T> out, StepAt step_at, std::size_t chunks)
+{
+    auto chunk_map = [&](std::size_t first, std::size_t last)
+    {
+        auto m = step_at(first);
+        for (auto i = first + 1; i < last; ++i) m = then(m, step_at(i));
+        return m;
+    };
+    parallel_scan(pool, start, out, step_at, chunk_map, chunks);
+}
+
+#endif
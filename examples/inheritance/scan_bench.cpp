@@ -0,0 +1,118 @@
+// g++ -std=c++20 -O2 -march=native -pthread scan_bench.cpp affine_sequence.cpp
+//
+// scan_bench [size=33554432] [max_threads=hardware_concurrency]
+// 1. Error: AffineSequence::fill(out, pool) against the serial next() values
+//    for an arithmetic, a geometric and a contracting recurrence, in units
+//    of the bound documented in affine_sequence.hpp (must stay <= 1); then
+//    the same for steps that change with i (parallel_scan composing them)
+// 2. Scaling: virtual next() per value, serial fill(), parallel fill()
+//    with 1, 2, 4, ... up to max_threads threads
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../concurrency/thread_pool.hpp"
+#include "affine_sequence.hpp"
+#include "scan.hpp"
+
+struct Case
+{
+    char const* name;
+    double start, factor, step;
+};
+
+int main(int argc, char* argv[])
+{
+    auto n = bench::max_size(argc, argv, size_t(1) << 25);
+    auto max_threads = bench::max_threads(argc, argv);
+
+    std::vector<double> serial(n), parallel(n);
+    auto pool = ThreadPool{max_threads};
+    auto chunks = 4 * pool.size();
+
+    Case const cases[] = {
+        {"arithmetic", 1, 1, 0.1},
+        {"geometric", 1, 1 + 1e-9, 0},
+        {"contracting", 0, 1 - 1e-6, 1},
+    };
+
+    std::printf("%zu values, %u threads, %zu chunks\n\n", n, max_threads, chunks);
+    std::printf("%-12s %16s %16s %14s\n", "", "last value", "max rel. diff", "diff / bound");
+    auto ok = true;
+    for (auto const& c : cases)
+    {
+        AffineSequence{c.start, c.factor, c.step}.fill(serial);
+        AffineSequence{c.start, c.factor, c.step}.fill(parallel, pool, chunks);
+
+        auto s = std::abs(c.start);
+        auto relative = 0.0, ratio = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto diff = std::abs(parallel[i] - serial[i]);
+            if (diff > 0)
+            {
+                relative = std::max(relative, diff / s);
+                ratio = std::max(ratio, diff / AffineSequence::error_bound(i, chunks, s));
+            }
+            s = std::abs(c.factor) * s + std::abs(c.step);
+        }
+        ok = ok && ratio <= 1;
+        std::printf("%-12s %16.9g %16.3e %14.3e\n", c.name, serial.back(), relative, ratio);
+    }
+
+    // a factor between 1 - 5e-8 and 1 + 5e-8 that changes every step, then add 1
+    auto step_at = [](size_t i) { return Affine{1 + 1e-7 * (double(i * 7919 % 1000) / 1000 - 0.5), 1}; };
+    {
+        auto x = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            serial[i] = x;
+            x = step_at(i)(x);
+        }
+        parallel_scan(pool, 0.0, std::span{parallel}, step_at, chunks);
+
+        auto relative = 0.0, ratio = 0.0;
+        for (size_t i = 1; i < n; ++i)   // all values positive, S[i] = x[i]
+        {
+            auto diff = std::abs(parallel[i] - serial[i]);
+            relative = std::max(relative, diff / serial[i]);
+            ratio = std::max(ratio, diff / AffineSequence::error_bound(i, chunks, serial[i]));
+        }
+        ok = ok && ratio <= 1;
+        std::printf("%-12s %16.9g %16.3e %14.3e\n", "varying", serial.back(), relative, ratio);
+    }
+
+    auto const& c = cases[2];
+    auto per_value = bench::best_of(3, [&]
+    {
+        AffineSequence a{c.start, c.factor, c.step};
+        Sequence& s = a;
+        for (auto& x : serial)
+        {
+            x = s.value();
+            s.next();
+        }
+    });
+    auto serial_fill = bench::best_of(3, [&] { AffineSequence{c.start, c.factor, c.step}.fill(serial); });
+
+    std::printf("\n%-24s %12s %12s %10s\n", "", "time [s]", "ns/value", "speedup");
+    auto row = [&](std::string const& what, double seconds)
+    {
+        std::printf("%-24s %12.4f %12.3f %10.2f\n", what.c_str(), seconds, seconds / n * 1e9, serial_fill / seconds);
+    };
+    row("next() per value", per_value);
+    row("fill(), serial", serial_fill);
+    for (auto threads : bench::thread_counts(max_threads))
+    {
+        auto workers = ThreadPool{threads};
+        row("fill(), " + std::to_string(threads) + " threads",
+            bench::best_of(3, [&] { AffineSequence{c.start, c.factor, c.step}.fill(parallel, workers); }));
+    }
+
+    std::printf("\n%s\n", ok ? "parallel within the error bound" : "ERROR: parallel outside the error bound");
+    return !ok;
+}
@@ -1,6 +1,8 @@
 #ifndef SEQUENCE_HPP
 #define SEQUENCE_HPP
 
+#include <span>
+
 class Sequence
 {
 public:
@@ -15,6 +17,17 @@ public:
 	
     Number value() const { return current_; }
     virtual void next() = 0;
+
+	// the next out.size() values, as if calling value() and next() for each;
+	// subclasses with a closed form compute them all without a call per value
+	virtual void fill(std::span<Number> out)
+	{
+		for (auto& x : out)
+		{
+			x = current_;
+			next();
+		}
+	}
 	
 protected:    
     Number current_;
@@ -0,0 +1,60 @@
+// g++ -std=c++20 -O2 -march=native sequence_bench.cpp arithmetic_sequence.cpp geometric_sequence.cpp
+//
+// sequence_bench [max_size=1000000]
+// Terms of an arithmetic and a geometric sequence, one virtual next() and
+// value() per term against one fill() for all of them. Every result is
+// checked against the closed form, the geometric one with a relative error
+// (next() accumulates one rounding per term, fill() at most one per block).
+
+#include <cmath>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "arithmetic_sequence.hpp"
+#include "geometric_sequence.hpp"
+
+struct State
+{
+	std::unique_ptr<Sequence> sequence;
+	std::vector<Sequence::Number> terms;
+};
+
+template <typename Make, typename Expected>
+void add(std::string const& name, Make make, Expected expected, double tolerance)
+{
+	auto setup = [=](size_t size) { return State{make(), std::vector<Sequence::Number>(size)}; };
+	auto check = [=](State const& state)
+	{
+		for (size_t i = 0; i < state.terms.size(); ++i)
+		{
+			auto e = expected(i);
+			if (std::abs(state.terms[i] - e) > tolerance * std::abs(e)) return false;
+		}
+		return true;
+	};
+
+	bench::add(name + " next()", setup, [](State& state)
+	{
+		auto& s = *state.sequence;
+		for (auto& x : state.terms)
+		{
+			x = s.value();
+			s.next();
+		}
+	}, check);
+	bench::add(name + " fill()", setup, [](State& state) { state.sequence->fill(state.terms); }, check);
+}
+
+int main(int argc, char* argv[])
+{
+	// 0.5 and 2^-20 are exact, so are all terms up to 2^53
+	add("arithmetic", [] { return std::make_unique<ArithmeticSequence>(1, 0.5); },
+		[](size_t i) { return 1 + 0.5 * double(i); }, 0);
+	add("geometric", [] { return std::make_unique<GeometricSequence>(1, 1 + 0x1p-20); },
+		[](size_t i) { return double(std::pow(1 + 0x1p-20L, (long double)i)); }, 1e-9);
+
+	return bench::run(argc, argv, {}, 1'000'000, 1000);
+}
@@ -1,7 +1,12 @@
 #ifndef ARITHMETIC_SEQUENCE_HPP
 #define ARITHMETIC_SEQUENCE_HPP
 
-class ArithmeticSequence
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include "sequence_iterator.hpp"
+
+class ArithmeticSequence : public std::ranges::view_interface<ArithmeticSequence>
 {
 public:
 	using Number = double;
@@ -9,6 +14,17 @@ public:
     ArithmeticSequence(Number start, Number step);
     Number value() const;
     void next();
+
+    // the terms from value() on, without end; seq[n] and it[n] in closed form
+    using iterator = SequenceIterator<ArithmeticSequence>;
+    iterator begin() const { return {current_, step_}; }
+    std::unreachable_sentinel_t end() const { return std::unreachable_sentinel; }
+
+    // the first n terms as a sized range: drop and take index into it, on the endless
+    // range above drop steps, because unreachable_sentinel gives it no distance
+    std::ranges::subrange<iterator> terms(std::ptrdiff_t n) const { return {begin(), begin() + n}; }
+
+    static Number term(Number first, Number step, std::ptrdiff_t n) { return first + Number(n) * step; }
 private:    
     Number current_;
     Number step_;
@@ -1,7 +1,13 @@
 #ifndef GEOMETRIC_SEQUENCE_HPP
 #define GEOMETRIC_SEQUENCE_HPP
 
-class GeometricSequence
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include "sequence_iterator.hpp"
+
+class GeometricSequence : public std::ranges::view_interface<GeometricSequence>
 {
 public:
 	using Number = double;
@@ -9,6 +15,20 @@ public:
     GeometricSequence(Number start, Number factor);
     Number value() const;
     void next();
+
+    // the terms from value() on, without end; ++ multiplies by the factor like next(),
+    // seq[n] and it[n] take the closed form with std::pow
+    using iterator = SequenceIterator<GeometricSequence>;
+    iterator begin() const { return {current_, factor_}; }
+    std::unreachable_sentinel_t end() const { return std::unreachable_sentinel; }
+
+    // the first n terms as a sized range: drop and take index into it, on the endless
+    // range above drop steps, because unreachable_sentinel gives it no distance
+    std::ranges::subrange<iterator> terms(std::ptrdiff_t n) const { return {begin(), begin() + n}; }
+
+    static Number term(Number first, Number factor, std::ptrdiff_t n) { return first * std::pow(factor, Number(n)); }
+    static Number next_term(Number term, Number factor) { return term * factor; }
+    static Number previous_term(Number term, Number factor) { return term / factor; }
 private:    
     Number current_;
     Number factor_;
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <ranges>
 #include "arithmetic_sequence.hpp"
 #include "geometric_sequence.hpp"
 
@@ -6,19 +7,17 @@ int main()
 {
     auto odd = ArithmeticSequence{1,2};
     
-    for (int i = 0; i < 10; ++i)
+    for (auto x : odd | std::views::take(10))
     {
-        std::cout << odd.value() << ' ';
-        odd.next();
+        std::cout << x << ' ';
     }
 	std::cout << '\n';
 	
     auto powers_of_2 = GeometricSequence{1,2};
     
-    for (int i = 0; i < 10; ++i)
+    for (auto x : powers_of_2 | std::views::take(10))
     {
-        std::cout << powers_of_2.value() << ' ';
-        powers_of_2.next();
+        std::cout << x << ' ';
     }
 	std::cout << '\n';
 }
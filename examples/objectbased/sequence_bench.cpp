@@ -0,0 +1,105 @@
+// g++ -std=c++20 -O2 -march=native sequence_bench.cpp arithmetic_sequence.cpp geometric_sequence.cpp
+//
+// sequence_bench [max_size=10000000]
+// View pipelines over the sequences against the hand-written loop over the
+// closed form: both must give exactly the same sum, and about the same time.
+// The geometric loop multiplies by the factor per term like next(), and so
+// does ++ on the view, which takes pow only to jump: the sums are the same.
+// drop on the endless sequence steps to its first term, drop on terms(n) indexes.
+// views::stride is C++23 (GCC 13); without it the stride case indexes
+// seq[k * i] through views::iota, which is what stride does for random access.
+
+#include <cmath>
+#include <cstddef>
+#include <ranges>
+#include <string>
+
+#include "../benchmarking/bench.hpp"
+#include "arithmetic_sequence.hpp"
+#include "geometric_sequence.hpp"
+
+struct State
+{
+	std::size_t size;
+	double sum;
+};
+
+constexpr std::ptrdiff_t skipped = 1000;
+constexpr std::ptrdiff_t every = 3;
+
+auto square = [](double x) { return x * x; };
+
+template <typename Pipeline, typename Loop>
+void add(std::string const& name, Pipeline pipeline, Loop loop, double tolerance = 0)
+{
+	auto setup = [](std::size_t size) { return State{size, 0}; };
+	auto check = [=](State const& state)
+	{
+		auto expected = loop(state.size);
+		return std::abs(state.sum - expected) <= tolerance * std::abs(expected);
+	};
+	bench::add(name + " view", setup, [=](State& state) { state.sum = pipeline(state.size); }, check);
+	bench::add(name + " loop", setup, [=](State& state) { state.sum = loop(state.size); }, check);
+}
+
+int main(int argc, char* argv[])
+{
+	auto const odd = ArithmeticSequence{1, 2};
+	auto const growth = GeometricSequence{1, 1 + 1e-9};
+
+	add("drop|take|transform", [=](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (auto x : odd | std::views::drop(skipped) | std::views::take(n) | std::views::transform(square)) sum += x;
+		return sum;
+	}, [](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (std::ptrdiff_t i = skipped; i < skipped + std::ptrdiff_t(n); ++i) sum += square(1 + double(i) * 2);
+		return sum;
+	});
+
+	add("terms|drop|transform", [=](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (auto x : odd.terms(skipped + std::ptrdiff_t(n)) | std::views::drop(skipped) | std::views::transform(square)) sum += x;
+		return sum;
+	}, [](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (std::ptrdiff_t i = skipped; i < skipped + std::ptrdiff_t(n); ++i) sum += square(1 + double(i) * 2);
+		return sum;
+	});
+
+	add("stride|take", [=](std::size_t n)
+	{
+		auto sum = 0.0;
+#if defined(__cpp_lib_ranges_stride)
+		for (auto x : odd | std::views::stride(every) | std::views::take(n)) sum += x;
+#else
+		auto strided = std::views::iota(std::ptrdiff_t(0)) | std::views::transform([=](auto i) { return odd[every * i]; });
+		for (auto x : strided | std::views::take(n)) sum += x;
+#endif
+		return sum;
+	}, [](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (std::ptrdiff_t i = 0; i < std::ptrdiff_t(n); ++i) sum += 1 + double(every * i) * 2;
+		return sum;
+	});
+
+	add("geometric take", [=](std::size_t n)
+	{
+		auto sum = 0.0;
+		for (auto x : growth | std::views::take(n)) sum += x;
+		return sum;
+	}, [](std::size_t n)
+	{
+		auto sum = 0.0;
+		auto x = 1.0;
+		for (std::size_t i = 0; i < n; ++i, x *= 1 + 1e-9) sum += x;
+		return sum;
+	});
+
+	return bench::run(argc, argv, {}, 10'000'000, 1000);
+}
@@ -0,0 +1,75 @@
+#ifndef SEQUENCE_ITERATOR_HPP
+#define SEQUENCE_ITERATOR_HPP
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+
+// Random access into an endless sequence. The iterator keeps the first term,
+// the step or factor, its position and its term. +=, -= and it[n] jump with the
+// closed form Sequence::term(first, parameter, position). ++ and -- take
+// Sequence::next_term(term, parameter) and previous_term where the sequence has
+// them, for a closed form dearer than one step like pow, and the closed form else.
+// The iterator does not point into the sequence, next() leaves it alone.
+template <typename Sequence>
+class SequenceIterator
+{
+public:
+    using Number = typename Sequence::Number;
+    using value_type = Number;
+    using difference_type = std::ptrdiff_t;
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;   // *it is no reference
+
+    SequenceIterator() = default;
+    SequenceIterator(Number first, Number parameter, difference_type position = 0)
+    : first_{first}
+    , parameter_{parameter}
+    , position_{position}
+    , term_{Sequence::term(first, parameter, position)}
+    {
+    }
+
+    Number operator*() const { return term_; }
+    Number operator[](difference_type n) const { return Sequence::term(first_, parameter_, position_ + n); }
+
+    SequenceIterator& operator++()
+    {
+        ++position_;
+        if constexpr (stepwise) term_ = Sequence::next_term(term_, parameter_);
+        else term_ = Sequence::term(first_, parameter_, position_);
+        return *this;
+    }
+
+    SequenceIterator& operator--()
+    {
+        --position_;
+        if constexpr (stepwise) term_ = Sequence::previous_term(term_, parameter_);
+        else term_ = Sequence::term(first_, parameter_, position_);
+        return *this;
+    }
+
+    SequenceIterator operator++(int) { auto old = *this; ++*this; return old; }
+    SequenceIterator operator--(int) { auto old = *this; --*this; return old; }
+    SequenceIterator& operator+=(difference_type n) { return *this = {first_, parameter_, position_ + n}; }
+    SequenceIterator& operator-=(difference_type n) { return *this = {first_, parameter_, position_ - n}; }
+
+    friend SequenceIterator operator+(SequenceIterator it, difference_type n) { return it += n; }
+    friend SequenceIterator operator+(difference_type n, SequenceIterator it) { return it += n; }
+    friend SequenceIterator operator-(SequenceIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(SequenceIterator const& a, SequenceIterator const& b) { return a.position_ - b.position_; }
+
+    // only iterators into the same sequence are compared
+    friend bool operator==(SequenceIterator const& a, SequenceIterator const& b) { return a.position_ == b.position_; }
+    friend auto operator<=>(SequenceIterator const& a, SequenceIterator const& b) { return a.position_ <=> b.position_; }
+
+private:
+    static constexpr bool stepwise = requires(Number x) { Sequence::next_term(x, x); Sequence::previous_term(x, x); };
+
+    Number first_{};
+    Number parameter_{};
+    difference_type position_ = 0;
+    Number term_{};
+};
+
+#endif
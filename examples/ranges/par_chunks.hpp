@@ -0,0 +1,164 @@
+#ifndef PAR_CHUNKS_HPP
+#define PAR_CHUNKS_HPP
+
+// Chunked parallel evaluation of element-wise stages (filter, transform, ...):
+//   source | par_chunks(pool, n, filter(p) | transform(f)) | drop(10) | take(3) | to_vector()
+// cuts the source into chunks of n elements, runs chunk | stages for a wave of chunks
+// on the pool and yields all results in source order. The result is an input view:
+// drop, take and whatever follows see one sequence and keep their sequential meaning.
+// Evaluation stays one wave ahead of the consumer, so take(3) computes at most one wave.
+// The stages are passed separately because std::views::transform does not expose its
+// function, so a finished pipeline cannot be cut into chunks afterwards.
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "../concurrency/thread_pool.hpp"
+
+template <std::ranges::view V, typename Stages>
+	requires std::ranges::forward_range<V>
+class ParChunksView : public std::ranges::view_interface<ParChunksView<V, Stages>>
+{
+	using Chunk = std::ranges::subrange<std::ranges::iterator_t<V>>;
+	using Value = std::ranges::range_value_t<decltype(std::declval<Chunk>() | std::declval<Stages const&>())>;
+
+public:
+	class iterator
+	{
+	public:
+		using value_type = Value;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+		explicit iterator(ParChunksView* view) : view_{view} {}
+
+		Value const& operator*() const { return view_->wave_[view_->chunk_][view_->element_]; }
+		iterator& operator++() { view_->advance(); return *this; }
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(iterator const& it, std::default_sentinel_t) { return it.at_end(); }
+
+	private:
+		bool at_end() const { return view_->chunk_ == view_->wave_.size(); }
+
+		ParChunksView* view_ = nullptr;
+	};
+
+	ParChunksView(V base, ThreadPool& pool, size_t chunk_size, Stages stages)
+	: base_{std::move(base)}, stages_{std::move(stages)}, pool_{&pool}, chunk_size_{std::max<size_t>(1, chunk_size)}
+	{
+	}
+
+	// single pass: begin() starts evaluating the source from its beginning
+	iterator begin()
+	{
+		next_ = std::ranges::begin(base_);
+		load();
+		skip_empty();
+		return iterator{this};
+	}
+
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	// the next wave of up to two chunks per thread, all of them in parallel
+	void load()
+	{
+		auto const last = std::ranges::end(base_);
+		chunks_.clear();
+		while (chunks_.size() < 2 * pool_->size() && next_ != last)
+		{
+			auto first = next_;
+			std::ranges::advance(next_, std::ranges::range_difference_t<V>(chunk_size_), last);
+			chunks_.emplace_back(first, next_);
+		}
+
+		wave_.resize(chunks_.size());
+		TaskGroup group{*pool_};
+		for (size_t c = 0; c < chunks_.size(); ++c)
+		{
+			group.run([this, c]
+			{
+				wave_[c].clear();
+				for (auto&& x : chunks_[c] | stages_) wave_[c].push_back(std::forward<decltype(x)>(x));
+			});
+		}
+		group.wait();
+
+		chunk_ = 0;
+		element_ = 0;
+	}
+
+	void advance()
+	{
+		++element_;
+		skip_empty();
+	}
+
+	// onto the next element, loading waves until there is one or the source is exhausted
+	void skip_empty()
+	{
+		while (true)
+		{
+			while (chunk_ < wave_.size() && element_ == wave_[chunk_].size())
+			{
+				++chunk_;
+				element_ = 0;
+			}
+			if (chunk_ < wave_.size() || next_ == std::ranges::end(base_)) return;
+			load();
+		}
+	}
+
+	V base_;
+	Stages stages_;
+	ThreadPool* pool_;
+	size_t chunk_size_;
+
+	std::ranges::iterator_t<V> next_{};
+	std::vector<Chunk> chunks_;
+	std::vector<std::vector<Value>> wave_;
+	size_t chunk_ = 0;
+	size_t element_ = 0;
+};
+
+template <typename Stages>
+struct ParChunks
+{
+	ThreadPool& pool;
+	size_t chunk_size;
+	Stages stages;
+
+	template <std::ranges::viewable_range R>
+	friend auto operator|(R&& r, ParChunks const& adaptor)
+	{
+		return ParChunksView{std::views::all(std::forward<R>(r)), adaptor.pool, adaptor.chunk_size, adaptor.stages};
+	}
+};
+
+template <typename Stages>
+ParChunks<Stages> par_chunks(ThreadPool& pool, size_t chunk_size, Stages stages)
+{
+	return {pool, chunk_size, std::move(stages)};
+}
+
+// r | to_vector(), until std::ranges::to<std::vector>() of C++23
+struct ToVector
+{
+	template <std::ranges::input_range R>
+	friend auto operator|(R&& r, ToVector)
+	{
+		std::vector<std::ranges::range_value_t<R>> result;
+		if constexpr (std::ranges::sized_range<R>) result.reserve(std::ranges::size(r));
+		for (auto&& x : r) result.push_back(std::forward<decltype(x)>(x));
+		return result;
+	}
+};
+
+inline ToVector to_vector() { return {}; }
+
+#endif
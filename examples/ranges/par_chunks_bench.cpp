@@ -0,0 +1,90 @@
+// g++ -std=c++20 -O2 -march=native -pthread par_chunks_bench.cpp
+//
+// par_chunks_bench [max_size=1000000] [threads=hardware_concurrency] [chunk_size=4096]
+// Each pipeline sequentially and with par_chunks; both must give the same vector.
+// * primes     iota(0, size) | filter(is_prime) | transform(square), costly filter
+// * sqrt       random vector | transform(sqrt) | filter(> 0.5), cheap stages
+// * drop|take  iota(0) | filter(is_prime) | drop(size / 10) | take(100), unbounded source:
+//              par_chunks stops one wave after the last element taken
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "par_chunks.hpp"
+#include "primes.hpp"
+
+template <typename T>
+struct State
+{
+	size_t size;
+	std::vector<T> result;
+};
+
+// the sequential and the par_chunks version of one pipeline, size -> vector
+template <typename Sequential, typename Parallel>
+void add(std::string const& name, Sequential sequential, Parallel parallel)
+{
+	using T = typename decltype(sequential(size_t{}))::value_type;
+	auto setup = [](size_t size) { return State<T>{size, {}}; };
+	// the sequential result, computed once per size
+	auto check = [=](State<T> const& state) { return state.result == bench::cached(sequential, state.size); };
+	bench::add(name + " sequential", setup, [=](State<T>& state) { state.result = sequential(state.size); }, check);
+	bench::add(name + " par_chunks", setup, [=](State<T>& state) { state.result = parallel(state.size); }, check);
+}
+
+auto const& random_input(size_t size)
+{
+	return bench::cached([](size_t n)
+	{
+		auto random = bench::Xoshiro256{n};
+		std::vector<double> values(n);
+		for (auto& x : values) x = bench::unit(random());
+		return values;
+	}, size);
+}
+
+int main(int argc, char* argv[])
+{
+	auto threads = bench::max_threads(argc, argv);
+	auto chunk_size = argc > 3 ? size_t(std::strtoull(argv[3], nullptr, 10)) : size_t(4096);
+	static auto pool = ThreadPool{threads};
+
+	using namespace std::views;
+	auto square = [](std::int64_t x) { return x * x; };
+	auto above_half = [](double x) { return x > 0.5; };
+	auto sqrt = [](double x) { return std::sqrt(x); };
+
+	add("primes", [=](size_t size)
+	{
+		return iota(std::int64_t{0}, std::int64_t(size)) | filter(is_prime) | transform(square) | to_vector();
+	}, [=](size_t size)
+	{
+		return iota(std::int64_t{0}, std::int64_t(size)) | par_chunks(pool, chunk_size, filter(is_prime) | transform(square)) | to_vector();
+	});
+
+	add("sqrt", [=](size_t size)
+	{
+		return random_input(size) | transform(sqrt) | filter(above_half) | to_vector();
+	}, [=](size_t size)
+	{
+		return random_input(size) | par_chunks(pool, chunk_size, transform(sqrt) | filter(above_half)) | to_vector();
+	});
+
+	add("drop|take", [=](size_t size)
+	{
+		return iota(std::int64_t{0}) | filter(is_prime) | drop(size / 10) | take(100) | to_vector();
+	}, [=](size_t size)
+	{
+		return iota(std::int64_t{0}) | par_chunks(pool, chunk_size, filter(is_prime)) | drop(size / 10) | take(100) | to_vector();
+	});
+
+	std::cout << threads << " threads, chunks of " << chunk_size << '\n';
+	return bench::run(argc, argv, {}, 1'000'000, 1000);
+}
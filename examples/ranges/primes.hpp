@@ -0,0 +1,298 @@
+#ifndef PRIMES_HPP
+#define PRIMES_HPP
+
+// Segmented sieve of Eratosthenes on a mod-30 wheel.
+// One byte holds the eight numbers 30k + 1, 7, 11, 13, 17, 19, 23, 29; all others are multiples of 2, 3 or 5.
+// A block of bytes starts from a pattern with the multiples of 7, 11 and 13 removed and is then
+// sieved one L1-sized segment at a time; different blocks run on a ThreadPool.
+// * count_primes(n, pool)  number of primes <= n
+// * primes(pool)           lazy view of all primes 2, 3, 5, 7, ...
+// * is_prime(n)            trial division, the slow way the sieve replaces
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "../concurrency/thread_pool.hpp"
+
+namespace sieve
+{
+
+constexpr std::uint64_t residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr size_t segment_bytes = 32 * 1024;                    // 983040 numbers per L1 data cache
+constexpr size_t block_bytes = 16 * segment_bytes;             // one task
+
+// bit of the residue r in a byte, -1 for multiples of 2, 3 or 5
+constexpr auto bit_index = []
+{
+	std::array<int, 30> bits{};
+	bits.fill(-1);
+	for (int i = 0; i < 8; ++i) bits[residues[i]] = i;
+	return bits;
+}();
+
+inline std::uint64_t isqrt(std::uint64_t n)
+{
+	auto r = std::uint64_t(std::sqrt(double(n)));
+	while (r * r > n) --r;
+	while ((r + 1) * (r + 1) <= n) ++r;
+	return r;
+}
+
+// the primes 17 <= p <= n, which cross out numbers up to n * n; plain odd-only sieve
+inline std::vector<std::uint32_t> base_primes(std::uint64_t n)
+{
+	std::vector<bool> composite(n / 2 + 1);
+	std::vector<std::uint32_t> result;
+	for (std::uint64_t p = 3; p <= n; p += 2)
+	{
+		if (composite[p / 2]) continue;
+		if (p >= 17) result.push_back(std::uint32_t(p));
+		for (auto m = p * p; m <= n; m += 2 * p) composite[m / 2] = true;
+	}
+	return result;
+}
+
+// bytes 0 .. 1000 without the multiples of 7, 11 and 13; repeats every 7 * 11 * 13 bytes
+inline std::vector<std::uint8_t> const& presieved()
+{
+	static auto const pattern = []
+	{
+		std::vector<std::uint8_t> bytes(7 * 11 * 13, 0xFF);
+		for (std::uint64_t n = 0; n < 30 * bytes.size(); ++n)
+		{
+			auto bit = bit_index[n % 30];
+			if (bit >= 0 && (n % 7 == 0 || n % 11 == 0 || n % 13 == 0)) bytes[n / 30] &= ~(1u << bit);
+		}
+		return bytes;
+	}();
+	return pattern;
+}
+
+// bytes[i] gets the primes among 30 * (first + i) + residues;
+// base must hold the primes from 17 up to the square root of the last number
+inline void sieve_block(std::span<std::uint8_t> bytes, std::uint64_t first, std::span<std::uint32_t const> base)
+{
+	auto const& pattern = presieved();
+	for (size_t i = 0, phase = first % pattern.size(); i < bytes.size(); phase = 0)
+	{
+		auto n = std::min(bytes.size() - i, pattern.size() - phase);
+		std::memcpy(bytes.data() + i, pattern.data() + phase, n);
+		i += n;
+	}
+	if (first == 0) bytes[0] = 0b1111'1110;   // 1 is no prime, 7, 11 and 13 are
+
+	// for each residue of m, the multiples p * m step by p bytes and keep their bit
+	struct Crossing
+	{
+		std::uint32_t prime;
+		std::array<std::uint32_t, 8> next;
+		std::array<std::uint8_t, 8> mask;
+	};
+	auto const low = 30 * first;
+	auto const high = 30 * (first + bytes.size());
+	std::vector<Crossing> crossings;
+	for (std::uint64_t p : base)
+	{
+		if (p * p >= high) break;
+		auto& c = crossings.emplace_back(Crossing{std::uint32_t(p), {}, {}});
+		auto m0 = std::max(p, (low + p - 1) / p);
+		for (int j = 0; j < 8; ++j)
+		{
+			auto n = p * (m0 + (residues[j] + 30 - m0 % 30) % 30);
+			c.next[j] = std::uint32_t(std::min<std::uint64_t>(n / 30 - first, bytes.size()));
+			c.mask[j] = std::uint8_t(~(1u << bit_index[n % 30]));
+		}
+	}
+
+	for (size_t end = 0; end < bytes.size(); )
+	{
+		end = std::min(end + segment_bytes, bytes.size());
+		for (auto& c : crossings)
+		{
+			for (int j = 0; j < 8; ++j)
+			{
+				auto i = size_t(c.next[j]);
+				for (; i < end; i += c.prime) bytes[i] &= c.mask[j];
+				c.next[j] = std::uint32_t(i);
+			}
+		}
+	}
+}
+
+inline std::uint64_t count_bits(std::span<std::uint8_t const> bytes)
+{
+	std::uint64_t count = 0;
+	size_t i = 0;
+	for (; i + 8 <= bytes.size(); i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, bytes.data() + i, 8);
+		count += std::popcount(word);
+	}
+	for (; i < bytes.size(); ++i) count += std::popcount(bytes[i]);
+	return count;
+}
+
+inline ThreadPool& default_pool()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+} // namespace sieve
+
+inline std::uint64_t count_primes(std::uint64_t n, ThreadPool& pool = sieve::default_pool())
+{
+	using namespace sieve;
+	if (n < 7) return (n >= 2) + (n >= 3) + (n >= 5);
+
+	auto const bytes = n / 30 + 1;
+	auto const base = base_primes(isqrt(n));
+	auto const blocks = (bytes + block_bytes - 1) / block_bytes;
+	std::atomic<std::uint64_t> total{3};   // 2, 3 and 5
+
+	parallel_for(pool, blocks, blocks, [&](size_t first_block, size_t last_block)
+	{
+		std::vector<std::uint8_t> buffer(block_bytes);
+		for (auto b = first_block; b < last_block; ++b)
+		{
+			auto first = b * block_bytes;
+			auto part = std::span{buffer}.first(std::min<std::uint64_t>(block_bytes, bytes - first));
+			sieve_block(part, first, base);
+			if (first + part.size() == bytes)   // the last byte also holds numbers above n
+			{
+				auto below = std::upper_bound(std::begin(residues), std::end(residues), n % 30) - std::begin(residues);
+				part.back() &= std::uint8_t((1u << below) - 1);
+			}
+			total += count_bits(part);
+		}
+	});
+	return total;
+}
+
+// All primes, unbounded. Iteration sieves a byte table that doubles on demand (in parallel
+// once it spans several blocks) and keeps it: reaching n holds n / 30 bytes.
+// Copies of the view share the table, which is not thread-safe.
+class PrimeView : public std::ranges::view_interface<PrimeView>
+{
+	struct Table
+	{
+		ThreadPool* pool = nullptr;
+		std::vector<std::uint8_t> bytes;
+
+		std::uint8_t byte(size_t i)
+		{
+			while (i >= bytes.size()) extend();
+			return bytes[i];
+		}
+
+		void extend()
+		{
+			using namespace sieve;
+			auto first = bytes.size();
+			auto size = std::max(first, segment_bytes);
+			bytes.resize(first + size);
+			auto const base = base_primes(isqrt(30 * bytes.size()));
+			auto const blocks = (size + block_bytes - 1) / block_bytes;
+			auto run = [&](size_t first_block, size_t last_block)
+			{
+				for (auto b = first_block; b < last_block; ++b)
+				{
+					auto offset = b * block_bytes;
+					auto part = std::span{bytes}.subspan(first + offset, std::min(block_bytes, size - offset));
+					sieve_block(part, first + offset, base);
+				}
+			};
+			if (blocks == 1) run(0, 1);
+			else parallel_for(pool ? *pool : default_pool(), blocks, blocks, run);
+		}
+	};
+
+public:
+	class iterator
+	{
+	public:
+		using iterator_concept = std::bidirectional_iterator_tag;
+		using iterator_category = std::input_iterator_tag;   // * returns a value
+		using value_type = std::uint64_t;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+		iterator(Table* table, value_type prime) : table_{table}, prime_{prime} {}
+
+		value_type operator*() const { return prime_; }
+
+		iterator& operator++()
+		{
+			using namespace sieve;
+			if (prime_ < 7)
+			{
+				prime_ = prime_ == 2 ? 3 : prime_ == 3 ? 5 : 7;
+				return *this;
+			}
+			auto i = prime_ / 30;
+			auto bits = table_->byte(i) & (0xFFu << (bit_index[prime_ % 30] + 1)) & 0xFFu;
+			while (bits == 0) bits = table_->byte(++i);
+			prime_ = 30 * i + residues[std::countr_zero(bits)];
+			return *this;
+		}
+
+		iterator& operator--()
+		{
+			using namespace sieve;
+			if (prime_ <= 7)
+			{
+				prime_ = prime_ == 7 ? 5 : prime_ == 5 ? 3 : 2;
+				return *this;
+			}
+			auto i = prime_ / 30;
+			auto bits = table_->byte(i) & ((1u << bit_index[prime_ % 30]) - 1);
+			while (bits == 0) bits = table_->byte(--i);   // stops at 7 in byte 0
+			prime_ = 30 * i + residues[std::bit_width(bits) - 1];
+			return *this;
+		}
+
+		iterator operator++(int) { auto old = *this; ++*this; return old; }
+		iterator operator--(int) { auto old = *this; --*this; return old; }
+
+		friend bool operator==(iterator const& a, iterator const& b) { return a.prime_ == b.prime_; }
+
+	private:
+		Table* table_ = nullptr;
+		value_type prime_ = 2;
+	};
+
+	PrimeView() = default;
+	explicit PrimeView(ThreadPool& pool) { table_->pool = &pool; }
+
+	iterator begin() const { return {table_.get(), 2}; }
+	std::unreachable_sentinel_t end() const { return {}; }
+
+private:
+	std::shared_ptr<Table> table_ = std::make_shared<Table>();
+};
+
+// lazy: nothing is sieved before the first increment
+inline PrimeView primes() { return PrimeView{}; }
+inline PrimeView primes(ThreadPool& pool) { return PrimeView{pool}; }
+
+inline bool is_prime(std::int64_t n)
+{
+	if (n < 2) return false;
+	for (std::int64_t t = 2; t * t <= n; ++t)
+		if (n % t == 0) return false;
+	return true;
+}
+
+#endif
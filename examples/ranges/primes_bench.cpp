@@ -0,0 +1,111 @@
+// g++ -std=c++20 -O2 -march=native -pthread primes_bench.cpp
+//
+// primes_bench [limit=10000000000] [max_threads=hardware_concurrency]
+// 1. Correctness against a plain sieve of Eratosthenes up to 10^8: all primes of the
+//    primes() view forwards and backwards, count_primes(n) around the block boundaries
+//    and for all n < 1000; count_primes(limit) against the table below for powers of 10
+// 2. The first 10^5 primes: trial division in iota | filter against primes() | take
+// 3. count_primes(limit) with 1, 2, 4, ... up to max_threads threads
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../benchmarking/bench.hpp"
+#include "../benchmarking/random_data.hpp"
+#include "primes.hpp"
+
+// number of primes <= 10^k
+constexpr std::uint64_t pi_of_power_of_10[] = {
+	0, 4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534,
+	455052511, 4118054813, 37607912018,
+};
+
+// the textbook version, one flag per number
+std::vector<std::uint64_t> reference_primes(std::uint64_t n)
+{
+	std::vector<bool> composite(n + 1);
+	std::vector<std::uint64_t> result;
+	for (std::uint64_t p = 2; p <= n; ++p)
+	{
+		if (composite[p]) continue;
+		result.push_back(p);
+		for (auto m = p * p; m <= n; m += p) composite[m] = true;
+	}
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	auto limit = std::uint64_t(bench::max_size(argc, argv, 10'000'000'000));
+	auto max_threads = bench::max_threads(argc, argv);
+	auto pool = ThreadPool{max_threads};
+	auto ok = true;
+	auto check = [&](bool good, char const* what, std::uint64_t n)
+	{
+		if (!good) std::printf("ERROR: %s wrong at %llu\n", what, (unsigned long long)n);
+		ok = ok && good;
+	};
+
+	// 1. correctness
+	std::uint64_t const checked = 100'000'000;
+	auto const reference = reference_primes(checked);
+	{
+		auto view = primes(pool);
+		auto it = view.begin();
+		for (auto p : reference)
+		{
+			if (*it != p) { check(false, "primes()", p); break; }
+			++it;
+		}
+		for (auto p = reference.rbegin(); p != reference.rend(); ++p)
+		{
+			--it;
+			if (*it != *p) { check(false, "--primes()", *p); break; }
+		}
+	}
+	auto pi = [&](std::uint64_t n) { return std::uint64_t(std::upper_bound(begin(reference), end(reference), n) - begin(reference)); };
+	std::vector<std::uint64_t> ns;
+	for (std::uint64_t n = 0; n < 1000; ++n) ns.push_back(n);
+	for (std::uint64_t b = 30 * sieve::block_bytes; b < checked; b += 30 * sieve::block_bytes)
+		for (std::uint64_t d = 0; d < 60; ++d) ns.push_back(b + d - 30);
+	auto random = bench::Xoshiro256{42};
+	for (int i = 0; i < 20; ++i) ns.push_back(bench::bounded(random(), checked));
+	for (auto n : ns) check(count_primes(n, pool) == pi(n), "count_primes", n);
+	std::printf("checked primes() up to %llu and count_primes for %zu n: %s\n\n",
+		(unsigned long long)checked, ns.size(), ok ? "ok" : "ERROR");
+
+	// 2. the pipeline of ranges.cpp, before and after
+	using namespace std::views;
+	auto const first = 100'000;
+	std::uint64_t trial_sum = 0, sieve_sum = 0;
+	auto trial = bench::seconds([&] { for (auto p : iota(std::uint64_t{0}) | filter(is_prime) | take(first)) trial_sum += p; });
+	auto sieved = bench::seconds([&] { for (auto p : primes() | take(first)) sieve_sum += p; });
+	check(trial_sum == sieve_sum, "sum of the first primes", first);
+	std::printf("first %d primes: iota | filter(is_prime) %.4f s, primes() %.4f s\n\n", first, trial, sieved);
+
+	// 3. scaling
+	std::printf("%-24s %16s %12s %10s\n", "count_primes", "primes", "time [s]", "speedup");
+	auto one_thread = 0.0;
+	for (auto threads : bench::thread_counts(max_threads))
+	{
+		auto workers = ThreadPool{threads};
+		std::uint64_t count = 0;
+		auto time = bench::seconds([&] { count = count_primes(limit, workers); });
+		if (threads == 1) one_thread = time;
+
+		auto k = std::lround(std::log10(double(limit)));
+		if (k < long(std::size(pi_of_power_of_10)) && std::pow(10.0, double(k)) == double(limit))
+			check(count == pi_of_power_of_10[k], "pi(10^k)", limit);
+
+		auto what = std::to_string(threads) + " threads";
+		std::printf("%-24s %16llu %12.3f %10.2f\n", what.c_str(), (unsigned long long)count, time, one_thread / time);
+	}
+
+	std::printf("\n%s\n", ok ? "all counts match" : "ERROR: wrong counts");
+	return !ok;
+}
@@ -1,19 +1,11 @@
 #include <iostream>
 #include <ranges>
 
-auto is_prime(int n)
-{
-	if (n < 2) return false;
-	if (n == 2) return true;
-	for (int t = 3; t < n; t += 2)
-		if (n % t == 0) return false;
-		
-	return true;
-};
+#include "primes.hpp"
 
 int main()
 {
-	auto square = [](int x) { return x*x; };
+	auto square = [](auto x) { return x*x; };
 	
 	using namespace std::ranges::views;
 	auto sequence = iota(0) | filter(is_prime) | drop(10) | take(3) | reverse| transform(square);
@@ -21,4 +13,10 @@ int main()
 
 	// squares of prime number No. 11, 12, 13 in reverse order
 	for (auto e : sequence) std::cout << e << ' ';
+	std::cout << '\n';
+
+	// the same without trial division of every number: a segmented sieve, see primes.hpp
+	auto sieved = primes() | drop(10) | take(3) | reverse | transform(square);
+	for (auto e : sieved) std::cout << e << ' ';
+	std::cout << '\n';
 }